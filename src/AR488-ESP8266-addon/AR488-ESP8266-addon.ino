@@ -88,8 +88,8 @@ q0nU1TGSF3zN4hdWR07e7B22Qkg1UT9vQKCDbkYTI4Q=
 #endif
 
 // Terminators
-#define CR 0x13
-#define LF 0x10
+#define CR 0x0D
+#define LF 0x0A
 
 
 /***** Enable debug modes *****/
@@ -106,6 +106,25 @@ q0nU1TGSF3zN4hdWR07e7B22Qkg1UT9vQKCDbkYTI4Q=
 /***** Parameter variables *****/
 #define BAUD 115200		// serial baud rate
 
+// Also accept passthrough connections on the standard SCPI raw socket port
+// (comment out to disable)
+#define RAW_SCPI_PORT 5025
+
+// Maximum number of concurrent passthrough clients
+#define MAX_CLI 4
+
+// Serve the static web assets gzip compressed from AR488-ESP8266-assets.h
+// (run mkassets.py after changing them, or comment out to serve them as text)
+#define GZIP_ASSETS
+
+#ifdef GZIP_ASSETS
+  #include "AR488-ESP8266-assets.h"
+  #define SEND_ASSET(type, name, versioned) sendAsset(type, name##_gz, sizeof(name##_gz), name##_etag, versioned)
+#else
+  #define ASSET_VER VERSION
+  #define SEND_ASSET(type, name, versioned) AR488srv.send(200, type, name)
+#endif
+
 
 /***** Default WiFi AP mode config *****/
 const char *dfltSSID = "AR488wifi";
@@ -135,17 +154,35 @@ union cfgObj AP;
 /***** Server and client objects *****/
 
 WiFiServer passSrv(8488);
-WiFiClient passCli;
+#ifdef RAW_SCPI_PORT
+WiFiServer scpiSrv(RAW_SCPI_PORT);
+#endif
+WiFiClient passCli[MAX_CLI];
 
 
 /***** Buffers *****/
 // HTML page buffer
 const uint16_t htmlSize = 4096;
 char html[htmlSize];
-// Serial buffer
-const uint16_t sbSize = 64;
-uint8_t sBuf[sbSize];
-uint16_t sbPtr = 0;
+// Passthrough bridge buffers
+const uint16_t sbSize = 256;
+uint8_t txBuf[sbSize];    // TCP to serial
+uint16_t txPtr = 0;
+uint8_t rxBuf[sbSize];    // Serial to TCP
+uint16_t rxPtr = 0;
+unsigned long rxLast = 0; // Time (millis) the last serial byte was received
+
+// Passthrough client sessions
+#define NO_ADDR 0xFF
+uint8_t cliAddr[MAX_CLI]; // GPIB address selected by each client (NO_ADDR = not set)
+int8_t actCli = -1;       // Client that currently owns the serial link
+uint8_t busAddr = NO_ADDR;// Address last sent to the AR488 (NO_ADDR = unknown)
+uint8_t defAddr = NO_ADDR;// Configured address of the AR488, given to new clients
+#define NO_AUTO 0xFF
+uint8_t busAuto = NO_AUTO;// ++auto mode of the AR488 (NO_AUTO = unknown)
+bool inLine = false;      // Active client is part way through sending a line
+bool waitRsp = false;     // Waiting for the reply to the last line sent
+unsigned long lastAct = 0;// Time (millis) of the last activity on the serial link
 
 
 /***** Hash objects *****/
@@ -154,8 +191,12 @@ uint16_t sbPtr = 0;
 
 
 /***** Other misc items *****/
-// serial timout (milliseconds) to wait before sending TCP packet
+// serial timout (milliseconds) to wait before sending an unterminated TCP packet
 uint8_t pktTmo = 5;       
+// time (milliseconds) the serial link must be quiet before another client can use it
+uint8_t holdTmo = 50;
+// time (milliseconds) to wait for the reply to a query before another client can use it
+uint16_t rspTmo = 3500;
 // Current (last) web page sent
 char curPage[10] = {'\0'};
 
@@ -172,13 +213,13 @@ static const char wwwMainPage[] PROGMEM = R"EOF(
 <head>
 <meta charset="utf-8">
 <title>AR488 WiFi Configuration</title>
-<link rel="stylesheet" href="style">
-<script defer src="/script"></script>
-<script defer src="/cfgGenjs"></script>
-<script defer src="/cfgWiFijs"></script>
-<script defer src="/cfg488js"></script>
-<script defer src="/cfgAdmjs"></script>
-<script defer src="/SHA1js"></script>
+<link rel="stylesheet" href="style?v=)EOF" ASSET_VER R"EOF(">
+<script defer src="/script?v=)EOF" ASSET_VER R"EOF("></script>
+<script defer src="/cfgGenjs?v=)EOF" ASSET_VER R"EOF("></script>
+<script defer src="/cfgWiFijs?v=)EOF" ASSET_VER R"EOF("></script>
+<script defer src="/cfg488js?v=)EOF" ASSET_VER R"EOF("></script>
+<script defer src="/cfgAdmjs?v=)EOF" ASSET_VER R"EOF("></script>
+<script defer src="/SHA1js?v=)EOF" ASSET_VER R"EOF("></script>
 </head>
 <body onload="getPage('%s')";>
 <div class="mpage">
@@ -335,6 +376,7 @@ static const char cfg488Page[] PROGMEM = R"EOF(
 )EOF";
 
 
+#ifndef GZIP_ASSETS
 /***** Admin functions page *****/
 static const char cfgAdmPage[] PROGMEM = R"EOF(
 <form method="post" id="frmAdm" action="/admin">
@@ -790,6 +832,7 @@ function SHA1(msg){
   return temp.toLowerCase();
 }
 )EOF";
+#endif  // GZIP_ASSETS
 
 
 /***** Re-direct page *****/
@@ -903,6 +946,9 @@ void setup() {
       passSrv->begin();
 */
       passSrv.begin(AP.gpibp);
+#ifdef RAW_SCPI_PORT
+      scpiSrv.begin();
+#endif
     }
   }
 
@@ -911,65 +957,13 @@ void setup() {
 
 void loop() {
 
-  // Handle requests for web server
-  AR488srv.handleClient();
-
   // Is GPIB passthrough enabled?
   if (AP.gpib) {
-    // Handle incoming client connections
-    if (passCli.connected()) {
-
-      // Handle TCP connection, output to serial
-      while (passCli.available()) {
-        if (sbPtr < sbSize - 1) {
-          sBuf[sbPtr] = passCli.read();
-          sbPtr++;
-        }else{
-          break;
-        }
-      }
-
-      if (sbPtr) {
-        Serial.write(sBuf, sbPtr);
-        clrSBuf(sbPtr);
-      }
-        
-      // Handle serial input, output to TCP
-      while (Serial.available()) {
-        if (sbPtr < sbSize - 1) {
-          sBuf[sbPtr] = Serial.read();
-          sbPtr++;
-        }
-      }
-
-      if (sbPtr) {
-        passCli.write((char*)sBuf, sbPtr);
-        clrSBuf(sbPtr);
-      }
-
-#ifdef DEBUG_6
-      if (!passCli.connected()) Serial.println("<= disconnected.");
-#endif
-
-    } else {
-      // Wait for a connection
-//      passCli = passSrv->available();
-      passCli = passSrv.available();
-      if (passCli.connected()) {
-#ifdef DEBUG_6        
-        Serial.println("Connected =>");
-#endif
-        // Initialise buffer
-        clrSBuf(sbPtr);
-        delay(50);
-        // Clear spurious characters after connection established
-        while (passCli.available()) { passCli.read(); }
-      }else{
-        // Discard anything coming into the serial port
-        while (Serial.available()) { Serial.read(); }
-      }
-    }
+    // Service the web server only while the bridge is idle
+    if (!bridge()) AR488srv.handleClient();
   }else{
+    // Handle requests for web server
+    AR488srv.handleClient();
     // Discard anything coming into the serial port
     while (Serial.available()) { Serial.read(); }
   }
@@ -1188,6 +1182,12 @@ void startWebServer() {
   AR488srv.on("/set488", set488);    // Set GPIB parameters
   AR488srv.on("/admin", admin);      // Set WiFi parameters
 
+#ifdef GZIP_ASSETS
+  // Needed to answer conditional requests for cached assets
+  static const char *hdrs[] = {"If-None-Match"};
+  AR488srv.collectHeaders(hdrs, 1);
+#endif
+
 #ifdef DEBUG_2
   Serial.println(F("Initialising webserver..."));  
 #endif
@@ -1516,51 +1516,73 @@ void cfg488() {
 
 /***** Admin functions page *****/
 void cfgAdm() {
-  AR488srv.send(200, "text/html", cfgAdmPage);
+  SEND_ASSET("text/html", cfgAdmPage, false);
 }
 
 
 /***** Return CSS stylesheet *****/
 void lnkStyle() {
-  AR488srv.send(200, "text/html", css);
+  SEND_ASSET("text/css", css, true);
 }
 
 
 /***** Return main JavaScript code *****/
 void lnkScript() {
-  AR488srv.send(200, "text/html", lnkScriptJs);
+  SEND_ASSET("application/javascript", lnkScriptJs, true);
 }
 
 
 /***** JavaScript code for Ceneral config page *****/
 void cfgGenjs() {
-  AR488srv.send(200, "text/html", cfgGenJs);
+  SEND_ASSET("application/javascript", cfgGenJs, true);
 }
 
 
 /***** JavaScript code for WiFi config page *****/
 void cfgWiFijs() {
-  AR488srv.send(200, "text/html", cfgWifiJs);
+  SEND_ASSET("application/javascript", cfgWifiJs, true);
 }
 
 
 /***** JavaScript code for AR488 config page *****/
 void cfg488js() {
-  AR488srv.send(200, "text/html", cfg488Js);
+  SEND_ASSET("application/javascript", cfg488Js, true);
 }
 
 
 /***** JavaScript code for Admin page *****/
 void cfgAdmjs() {
-  AR488srv.send(200, "text/html", cfgAdmJs);
+  SEND_ASSET("application/javascript", cfgAdmJs, true);
 }
 
 
+/***** JavaScript SHA1 function *****/
 void SHA1js() {
-  AR488srv.send(200, "text/html", SHA1funcJs);
+  SEND_ASSET("application/javascript", SHA1funcJs, true);
 }
 
 
+#ifdef GZIP_ASSETS
+/***** Send a compressed asset *****/
+/*
+ * Versioned assets are linked with ASSET_VER in the URL, so the browser can
+ * keep them for a week and fetches them again when the assets change. Others
+ * are revalidated on each use. The ETag allows a revalidation to be answered
+ * without sending the asset again.
+ */
+void sendAsset(const char *type, const uint8_t *data, size_t len, const char *etag, bool versioned) {
+  AR488srv.sendHeader("Cache-Control", versioned ? "max-age=604800" : "no-cache");
+  AR488srv.sendHeader("ETag", etag);
+  if (AR488srv.header("If-None-Match") == etag) {
+    AR488srv.send(304);
+    return;
+  }
+  AR488srv.sendHeader("Content-Encoding", "gzip");
+  AR488srv.send_P(200, type, (PGM_P)data, len);
+}
+#endif
+
+
 /***** Set WiFi parameters *****/
 void setWifi() {
 //  bool stat = false;
@@ -1723,20 +1745,29 @@ void setGen() {
       if (passSrv.status() != CLOSED) passSrv.stop();
       delay(10);
       passSrv.begin(gpibp);
+#ifdef RAW_SCPI_PORT
+      if (scpiSrv.status() == CLOSED) scpiSrv.begin();
+#endif
     }
   } else {
     if (AP.gpib) {
-      // Disconnect any client
-      if (passCli.connected()) {
-        passCli.stop();
-        passCli.flush();
+      // Disconnect all clients
+      for (uint8_t i=0; i<MAX_CLI; i++) {
+        if (passCli[i].connected()) {
+          passCli[i].stop();
+          passCli[i].flush();
+        }
       }
+      actCli = -1;
       // Stop any processing in the main loop
       AP.gpib = false;
-      // Clear the receiving buffer
-      clrSBuf(sbPtr);      
+      // Clear the bridge buffers
+      clrSBuf();      
       // Stop the passthrough server (note: causes reboot!)
       passSrv.stop();
+#ifdef RAW_SCPI_PORT
+      scpiSrv.stop();
+#endif
     }
   }
 
@@ -1785,6 +1816,8 @@ void set488() {
 
   // Process parameters
   Serial.print(F("++addr ")); Serial.println(AR488srv.arg("gpib"));
+  busAddr = NO_ADDR;
+  if (AR488srv.arg("gpib").toInt() <= 30) defAddr = AR488srv.arg("gpib").toInt();
   flushIncoming();
   Serial.print(F("++eos ")); Serial.println(AR488srv.arg("eosch"));
   flushIncoming();
@@ -1797,6 +1830,8 @@ void set488() {
   // Set these only of controller mode is on
   if (ctrlr) {
     Serial.print(F("++auto ")); Serial.println(AR488srv.arg("auto"));
+    busAuto = NO_AUTO;
+    if (AR488srv.arg("auto").toInt() <= 3) busAuto = AR488srv.arg("auto").toInt();
     flushIncoming();
     Serial.print(F("++read_tmo_ms ")); Serial.println(AR488srv.arg("readtmo"));
     flushIncoming();
@@ -1944,6 +1979,210 @@ uint8_t getReply(const char* cmd, char *reply, int rsize) {
 }
 
 
+/***** TCP to serial passthrough bridge *****/
+/*
+ * Up to MAX_CLI clients can be connected at once. Each client's lines are
+ * passed to the AR488 one transaction at a time and the reply is returned to
+ * the client that sent the line. The client holding the link can send its
+ * next line (e.g. ++read after a query) straight away, which ends the wait
+ * for a reply to the previous one. Each client keeps its own GPIB address
+ * (the configured address until it sends ++addr), which is sent to the AR488
+ * whenever another client takes the link or the address has changed.
+ * Data from the AR488 is collected and sent to the client in one write when a
+ * LF arrives, the buffer is full or no more has arrived within pktTmo ms.
+ * Returns true while the bridge is busy.
+ */
+bool bridge() {
+  bool busy = false;
+  int8_t nxt;
+
+  // Accept new connections, drop closed ones
+  acceptClient();
+  if ((actCli >= 0) && !passCli[actCli].connected()) {
+#ifdef DEBUG_6
+    Serial.println("<= disconnected.");
+#endif
+    actCli = -1;
+    inLine = false;
+    waitRsp = false;
+  }
+
+  // Handle serial input, output to the client that owns the link
+  while (Serial.available() && (rxPtr < sbSize)) {
+    rxBuf[rxPtr] = Serial.read();
+    rxLast = millis();
+    lastAct = rxLast;
+    if (rxBuf[rxPtr++] == LF) break;
+  }
+  if (rxPtr) {
+    busy = true;
+    if ((rxBuf[rxPtr - 1] == LF) || (rxPtr == sbSize) || ((millis() - rxLast) >= pktTmo)) {
+      if (rxBuf[rxPtr - 1] == LF) waitRsp = false;
+      // Discarded if the client has gone
+      if (actCli >= 0) passCli[actCli].write((const uint8_t *)rxBuf, rxPtr);
+      rxPtr = 0;
+    }
+  }
+
+  // Handle TCP input, output to serial
+  if (inLine) {
+    // Finish the line already started
+    nxt = actCli;
+  }else{
+    // Next client with data, the active client last so others get a turn
+    nxt = nextClient();
+    // Another client has to wait until the current transaction is done, the
+    // client holding the link can carry on
+    if ((nxt >= 0) && (nxt != actCli) && (actCli >= 0) && !linkFree()) {
+      nxt = passCli[actCli].available() ? actCli : -1;
+    }
+  }
+  if ((nxt >= 0) && passCli[nxt].available()) {
+    if (!inLine) {
+      // Address the client's instrument when it takes the link or its address has changed
+      if ((cliAddr[nxt] != NO_ADDR) && ((nxt != actCli) || (cliAddr[nxt] != busAddr))) {
+        Serial.print(F("++addr ")); Serial.println(cliAddr[nxt]);
+        busAddr = cliAddr[nxt];
+      }
+      actCli = nxt;
+    }
+    txPtr = 0;
+    while (passCli[nxt].available() && (txPtr < sbSize)) {
+      txBuf[txPtr] = passCli[nxt].read();
+      if (txBuf[txPtr++] == LF) break;
+    }
+    if (!inLine) chkBusCmd(nxt);
+    Serial.write(txBuf, txPtr);
+    inLine = (txBuf[txPtr - 1] != LF);
+    if (!inLine) waitRsp = expectsReply();
+    lastAct = millis();
+    txPtr = 0;
+    busy = true;
+  }
+
+  return busy;
+}
+
+
+/***** Accept passthrough clients on the GPIB or SCPI port *****/
+void acceptClient() {
+  WiFiClient newCli = passSrv.available();
+#ifdef RAW_SCPI_PORT
+  if (!newCli) newCli = scpiSrv.available();
+#endif
+  if (!newCli) return;
+
+  // Nothing is using the link yet, read the configured address
+  if ((defAddr == NO_ADDR) && (actCli < 0) && !rxPtr) getBusCfg();
+
+  for (uint8_t i=0; i<MAX_CLI; i++) {
+    if (!passCli[i].connected()) {
+#ifdef DEBUG_6        
+      Serial.println("Connected =>");
+#endif
+      passCli[i] = newCli;
+      cliAddr[i] = defAddr;
+      // Send small packets straight away (disable Nagle)
+      passCli[i].setNoDelay(true);
+      delay(50);
+      // Clear spurious characters after connection established
+      while (passCli[i].available()) { passCli[i].read(); }
+      return;
+    }
+  }
+  // No free session
+  newCli.stop();
+}
+
+
+/***** Find the next client with data waiting (round robin) *****/
+int8_t nextClient() {
+  int8_t idx;
+  for (uint8_t i=1; i<=MAX_CLI; i++) {
+    idx = (actCli + i) % MAX_CLI;
+    if (passCli[idx].available()) return idx;
+  }
+  return -1;
+}
+
+
+/***** Has the last transaction finished? *****/
+bool linkFree() {
+  if (rxPtr || Serial.available()) return false;
+  if (waitRsp) return ((millis() - lastAct) >= rspTmo);
+  return ((millis() - lastAct) >= holdTmo);
+}
+
+
+/***** Read the address and auto mode configured on the AR488 *****/
+void getBusCfg() {
+  char reply[8];
+
+  flushIncoming();
+  if (getReply("++addr", reply, 8) && isDigit(reply[0])) {
+    defAddr = atoi(reply);
+    busAddr = defAddr;
+  }
+  if (getReply("++auto", reply, 8) && isDigit(reply[0])) busAuto = atoi(reply);
+}
+
+
+/***** Parameter of a '++cmd n' line in txBuf (-1 if not that command) *****/
+int16_t cmdParam(const char *cmd) {
+  uint16_t i = strlen(cmd);
+  int16_t val = 0;
+
+  if ((txPtr < i + 2) || (strncmp((char *)txBuf, cmd, i) != 0)) return -1;
+  if (txBuf[i] != ' ') return -1;
+  while ((i < txPtr) && (txBuf[i] == ' ')) i++;
+  if ((i == txPtr) || !isDigit(txBuf[i])) return -1;
+  while ((i < txPtr) && isDigit(txBuf[i]) && (val < 1000)) {
+    val = (val * 10) + (txBuf[i] - '0');
+    i++;
+  }
+  return val;
+}
+
+
+/***** Record the address (++addr) and auto mode (++auto) set by a client *****/
+void chkBusCmd(uint8_t cli) {
+  int16_t val;
+
+  val = cmdParam("++addr");
+  if ((val >= 0) && (val <= 30)) {
+    cliAddr[cli] = val;
+    busAddr = val;
+  }
+  val = cmdParam("++auto");
+  if ((val >= 0) && (val <= 3)) busAuto = val;
+}
+
+
+/***** Does the line in txBuf produce a reply? *****/
+/*
+ * Queries reply unless ++auto is 0 (the reply then waits for ++read) and
+ * with ++auto 1 every line is read back. ++ commands without parameters
+ * (e.g. '++addr', '++ver') reply, as do ++read and ++spoll.
+ */
+bool expectsReply() {
+  uint16_t i;
+
+  if ((txPtr < 2) || (txBuf[0] != '+') || (txBuf[1] != '+')) {
+    if (busAuto == 1) return true;
+    for (i=0; i<txPtr; i++) {
+      if (txBuf[i] == '?') return (busAuto != 0);
+    }
+    return false;
+  }
+  if (strncmp((char *)txBuf, "++read", 6) == 0) return true;
+  if (strncmp((char *)txBuf, "++spoll", 7) == 0) return true;
+  for (i=2; i<txPtr; i++) {
+    if (txBuf[i] == ' ') return false;
+  }
+  return true;
+}
+
+
 /***** Flush the incoming buffer *****/
 void flushIncoming() {
   while (Serial.available()) {
@@ -1952,10 +2191,12 @@ void flushIncoming() {
 }
 
 
-/***** Clear buffer *****/
-void clrSBuf(uint16_t ptr) {
-  memset(sBuf, '\0',ptr);
-  sbPtr = 0;
+/***** Clear bridge buffers *****/
+void clrSBuf() {
+  txPtr = 0;
+  rxPtr = 0;
+  inLine = false;
+  waitRsp = false;
 }
 
 
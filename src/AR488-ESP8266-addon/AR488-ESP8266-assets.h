@@ -0,0 +1,326 @@
+/*
+ * Compressed web assets - generated by mkassets.py, do not edit.
+ */
+
+#ifndef AR488_ESP8266_ASSETS_H
+#define AR488_ESP8266_ASSETS_H
+
+// cfgAdmPage: 908 bytes uncompressed
+#define cfgAdmPage_etag "\"1e2d42e36d4c750b\""
+static const uint8_t cfgAdmPage_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x93, 0xc1, 0x52, 0x83, 0x30,
+  0x10, 0x86, 0xef, 0x3c, 0x45, 0x26, 0xa7, 0x7a, 0xa2, 0xad, 0x37, 0x05, 0x66, 0x94, 0x8e, 0x47,
+  0xc7, 0xe9, 0xc5, 0x73, 0x20, 0x81, 0x64, 0x1a, 0x12, 0x26, 0x59, 0x44, 0xdf, 0xde, 0x0d, 0x6d,
+  0xb4, 0x4a, 0xc7, 0xb6, 0x5e, 0x08, 0x2c, 0xff, 0xfe, 0xfb, 0x65, 0x37, 0x49, 0xb2, 0xc6, 0xba,
+  0x8e, 0x74, 0x02, 0xa4, 0xe5, 0x39, 0xed, 0xad, 0x07, 0x4a, 0x14, 0xbe, 0x35, 0xae, 0x7b, 0xe0,
+  0x1d, 0x25, 0xac, 0x06, 0x65, 0x4d, 0x4e, 0x53, 0xc6, 0x3b, 0x65, 0x68, 0x91, 0x64, 0xca, 0xf4,
+  0x03, 0x10, 0xc3, 0x3a, 0x91, 0xd3, 0x5a, 0xee, 0x56, 0x94, 0xbc, 0x31, 0x3d, 0xe0, 0x07, 0x25,
+  0xf0, 0xd1, 0xe3, 0x2a, 0x15, 0xe7, 0xc2, 0xd0, 0x74, 0xae, 0x5d, 0x5f, 0xaa, 0xb5, 0x3d, 0x44,
+  0xe9, 0x72, 0xae, 0x04, 0x56, 0x69, 0x11, 0x56, 0x57, 0x64, 0x20, 0x8b, 0x72, 0x70, 0x4e, 0x18,
+  0x20, 0x3d, 0xf3, 0x7e, 0xb4, 0x8e, 0xdf, 0x65, 0x29, 0x46, 0x33, 0xe0, 0xc5, 0xc1, 0x33, 0xec,
+  0xa7, 0x1f, 0xf9, 0x2a, 0x16, 0x8d, 0x42, 0x4a, 0xac, 0xa9, 0x25, 0x33, 0x2d, 0xc6, 0x84, 0x09,
+  0xa6, 0x8f, 0x03, 0x80, 0x35, 0x8b, 0xe5, 0xfb, 0xaa, 0xbc, 0xb9, 0xc7, 0x5a, 0xe8, 0xc4, 0xbf,
+  0x0b, 0x3d, 0x8b, 0xf1, 0x6c, 0x91, 0xf5, 0xac, 0xc8, 0x6f, 0x97, 0xd2, 0x9a, 0x46, 0x61, 0xcf,
+  0xcd, 0x05, 0x6e, 0xb7, 0x67, 0xdd, 0x62, 0x22, 0x61, 0x5a, 0xb5, 0x38, 0x27, 0xa7, 0x5a, 0x09,
+  0x34, 0xda, 0xec, 0x93, 0xab, 0x69, 0x57, 0xfb, 0xb9, 0x56, 0x60, 0x4a, 0x89, 0xce, 0x94, 0xd4,
+  0x1a, 0x3d, 0xa7, 0xc0, 0xd7, 0x54, 0xca, 0xa9, 0x19, 0x53, 0x5b, 0xb4, 0xaa, 0x77, 0x61, 0x66,
+  0xed, 0xcb, 0xc8, 0x17, 0xd8, 0x0b, 0xc2, 0x95, 0x0f, 0x1d, 0xe2, 0x07, 0x00, 0x7c, 0xb8, 0x39,
+  0x45, 0x91, 0x55, 0xee, 0xd4, 0xff, 0x8d, 0x68, 0xd8, 0xa0, 0xc1, 0xff, 0x83, 0x76, 0x1b, 0x4e,
+  0xe4, 0x09, 0xd6, 0xad, 0xf0, 0x02, 0x8e, 0x50, 0x9d, 0x87, 0x4d, 0xa3, 0xe1, 0x3c, 0x2b, 0x26,
+  0x02, 0x73, 0x40, 0x5e, 0xd5, 0x93, 0xba, 0x86, 0xe7, 0x98, 0x21, 0xb2, 0x55, 0x70, 0xc4, 0x53,
+  0x59, 0xfb, 0x03, 0x68, 0x0a, 0xfc, 0xc1, 0x93, 0xc6, 0x73, 0x9c, 0x86, 0x3b, 0x58, 0x24, 0x9f,
+  0x5a, 0x38, 0x35, 0x01, 0x8c, 0x03, 0x00, 0x00,
+};
+
+// css: 1480 bytes uncompressed
+#define css_etag "\"53ccc436381c10d6\""
+static const uint8_t css_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x54, 0x51, 0x6f, 0xe3, 0x20,
+  0x0c, 0x7e, 0xef, 0xaf, 0x40, 0x9a, 0xa6, 0x6d, 0x3a, 0x65, 0xca, 0xd2, 0xde, 0x76, 0x4b, 0x9f,
+  0xaa, 0xa9, 0xfd, 0x0d, 0xf7, 0x4a, 0x02, 0x49, 0x50, 0x29, 0x46, 0xc4, 0x5d, 0xdb, 0xab, 0xf6,
+  0xdf, 0xcf, 0x40, 0xc8, 0x72, 0x6b, 0x75, 0x43, 0x8a, 0x84, 0x0d, 0xfe, 0xfc, 0xd9, 0x9f, 0xc9,
+  0xac, 0x02, 0x71, 0x62, 0xe7, 0x83, 0x12, 0xd8, 0x95, 0x6c, 0x5e, 0xe4, 0x4b, 0xd6, 0x49, 0xd5,
+  0x76, 0x58, 0xb2, 0x45, 0xb1, 0x58, 0x7e, 0xcc, 0x90, 0x57, 0x5a, 0x8e, 0x17, 0x9e, 0xf2, 0xfc,
+  0xf6, 0x76, 0xc9, 0x1a, 0x30, 0x98, 0xf5, 0xea, 0x8f, 0xf4, 0x1e, 0x8b, 0x4b, 0x86, 0xf2, 0x88,
+  0x19, 0xd7, 0xaa, 0x35, 0x25, 0xd3, 0xb2, 0x41, 0x1f, 0xd8, 0xb1, 0xcf, 0xb0, 0x22, 0xb7, 0x47,
+  0xf2, 0xed, 0x35, 0xf9, 0xb4, 0xea, 0x29, 0x18, 0x4f, 0x5a, 0x66, 0x78, 0xb2, 0x04, 0x61, 0xc0,
+  0xc8, 0xe5, 0x8c, 0xb1, 0x1d, 0x77, 0xad, 0x22, 0x80, 0xdc, 0x1b, 0x96, 0x0b, 0xa1, 0x4c, 0x3b,
+  0x58, 0x89, 0x53, 0xb1, 0x20, 0x1c, 0xb2, 0xbf, 0x12, 0x20, 0xd7, 0x94, 0x42, 0x2d, 0x0d, 0x4a,
+  0x47, 0x09, 0xb5, 0xa2, 0x84, 0x8d, 0x06, 0x8e, 0x03, 0xaf, 0x48, 0xa8, 0xc8, 0x6f, 0xe3, 0x21,
+  0xa7, 0x63, 0xa1, 0x7a, 0xab, 0xf9, 0xa9, 0x64, 0x95, 0x86, 0x7a, 0xeb, 0xa1, 0x2a, 0x70, 0x42,
+  0x3a, 0x82, 0xb6, 0x47, 0xd6, 0x83, 0x56, 0x82, 0xdd, 0xbc, 0x84, 0xe5, 0x0f, 0x6b, 0xd0, 0x40,
+  0x67, 0x37, 0xf3, 0xb0, 0xc2, 0x75, 0x5e, 0x6f, 0x5b, 0x07, 0x7b, 0x23, 0xb2, 0x74, 0xb8, 0xd9,
+  0xac, 0xd7, 0xf1, 0x7a, 0xa0, 0x25, 0x64, 0x0d, 0x8e, 0xa3, 0x02, 0x33, 0x54, 0x1b, 0x93, 0x97,
+  0x1d, 0xbc, 0x53, 0x1e, 0x03, 0x78, 0xff, 0xc8, 0x6b, 0x54, 0xef, 0xf2, 0x81, 0x9d, 0xaf, 0x03,
+  0x5e, 0xe4, 0xaf, 0x4f, 0xdc, 0x10, 0xcc, 0x10, 0xc7, 0xce, 0x17, 0x31, 0x14, 0xf2, 0xf6, 0xb6,
+  0xd9, 0xf8, 0x3b, 0x9d, 0xe4, 0xc2, 0x51, 0xa5, 0x09, 0x2c, 0xa7, 0xb5, 0x5a, 0x7d, 0xed, 0xe3,
+  0x22, 0xf6, 0x31, 0xb8, 0x0e, 0x43, 0xbf, 0x2b, 0xd0, 0xc2, 0x3b, 0x27, 0xf3, 0x71, 0xbd, 0xd5,
+  0x53, 0xc5, 0x48, 0x91, 0x23, 0xf3, 0x5f, 0xda, 0x78, 0x0e, 0x0d, 0x00, 0x92, 0x14, 0x9f, 0xf9,
+  0x7e, 0x59, 0x3f, 0x25, 0x8f, 0x3b, 0xcb, 0x5b, 0xc9, 0xfe, 0x99, 0xc0, 0x89, 0xde, 0x7e, 0x06,
+  0xaf, 0x37, 0x64, 0x1d, 0xd6, 0x48, 0xb8, 0xe1, 0x3b, 0xa5, 0x49, 0x43, 0xea, 0xa7, 0xe0, 0x86,
+  0x7f, 0xab, 0x62, 0x9a, 0xb5, 0x97, 0x38, 0x4f, 0x89, 0xfb, 0x60, 0x56, 0x70, 0xcc, 0xfa, 0x8e,
+  0x0b, 0x38, 0x10, 0x23, 0x0a, 0x4f, 0xdf, 0xcd, 0x2a, 0xac, 0xe5, 0x8c, 0x88, 0xd7, 0x60, 0x1a,
+  0x76, 0xf6, 0x02, 0xd2, 0x7c, 0x1d, 0x32, 0xca, 0xcd, 0xf7, 0x08, 0x53, 0xf2, 0xf3, 0xdc, 0xd7,
+  0xee, 0xef, 0x2a, 0x3b, 0x16, 0xb8, 0x18, 0xfa, 0xd1, 0x1f, 0x14, 0xd6, 0x5d, 0x90, 0xdb, 0x42,
+  0xaf, 0xe2, 0x6c, 0x38, 0xa9, 0xb9, 0x97, 0xd3, 0xa3, 0x8c, 0x63, 0xa9, 0x8c, 0x56, 0x46, 0x66,
+  0xe3, 0x74, 0x26, 0xa0, 0x22, 0x72, 0x1d, 0x9f, 0x46, 0x4a, 0xd6, 0x53, 0xa9, 0xd2, 0x7d, 0x41,
+  0xe6, 0x15, 0xb5, 0x60, 0x8f, 0x01, 0xb9, 0xde, 0xbb, 0xde, 0xf7, 0xd0, 0x82, 0x4a, 0xda, 0x21,
+  0xd8, 0xe1, 0xa5, 0xf9, 0x57, 0x32, 0x6c, 0x5d, 0x04, 0xce, 0x63, 0x47, 0x10, 0x61, 0x97, 0x8c,
+  0x4b, 0x39, 0x8a, 0xa7, 0xd7, 0xe7, 0xcd, 0x7c, 0x92, 0xbf, 0xac, 0x64, 0x03, 0x4e, 0xfe, 0x8f,
+  0x06, 0xe9, 0x46, 0xc3, 0x53, 0xb2, 0xbb, 0xbb, 0x69, 0x1d, 0x4f, 0xcf, 0xb1, 0xae, 0xf4, 0xeb,
+  0x18, 0xcc, 0xc8, 0xab, 0x48, 0xfa, 0x44, 0x36, 0xc9, 0xbc, 0xe0, 0xd3, 0x2b, 0xfd, 0xee, 0x2b,
+  0xfb, 0x98, 0x29, 0x63, 0xf7, 0x58, 0xd6, 0x9d, 0xac, 0xb7, 0x52, 0xb0, 0x1f, 0xec, 0x0a, 0x3d,
+  0x9a, 0xf6, 0x6a, 0xab, 0x30, 0x43, 0xc7, 0x4d, 0x4f, 0x5e, 0x02, 0x0e, 0x5b, 0xd2, 0x42, 0xfe,
+  0xbe, 0x2f, 0x28, 0xc9, 0x83, 0xcf, 0x92, 0xed, 0xfa, 0xef, 0xae, 0x7c, 0x73, 0x7c, 0xc9, 0xb3,
+  0x0d, 0xef, 0x8b, 0x9a, 0x56, 0xa1, 0x19, 0x7f, 0x54, 0xa1, 0xef, 0x93, 0x16, 0xbc, 0xe6, 0xb1,
+  0xcc, 0x34, 0xb3, 0xe1, 0x59, 0xfd, 0x1c, 0xde, 0xd8, 0xa0, 0xfa, 0x5f, 0x0c, 0xc6, 0xc5, 0xc8,
+  0xc8, 0x05, 0x00, 0x00,
+};
+
+// lnkScriptJs: 1103 bytes uncompressed
+#define lnkScriptJs_etag "\"2e6288705a52e381\""
+static const uint8_t lnkScriptJs_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x92, 0x6f, 0x6f, 0xd3, 0x30,
+  0x10, 0xc6, 0xdf, 0xf7, 0x53, 0x1c, 0x99, 0x84, 0x63, 0x81, 0xcc, 0x86, 0x78, 0x81, 0xa8, 0x82,
+  0xc4, 0x5f, 0x81, 0xb4, 0x6a, 0x13, 0xd9, 0xc4, 0x6b, 0x37, 0xbe, 0xa4, 0x99, 0x52, 0x3b, 0xd8,
+  0x97, 0xa6, 0xd5, 0x94, 0xef, 0x8e, 0x9d, 0x26, 0xa1, 0x40, 0xd7, 0xbe, 0x88, 0xe4, 0x9c, 0x9f,
+  0xfb, 0xdd, 0xf9, 0xb9, 0x9b, 0x6d, 0xa4, 0x85, 0xac, 0xb1, 0x0b, 0x7d, 0xb3, 0x7c, 0x48, 0x18,
+  0x9b, 0xcf, 0xf2, 0x46, 0x67, 0x54, 0x1a, 0x0d, 0x05, 0xd2, 0xad, 0x2c, 0x30, 0x6e, 0x6c, 0xc5,
+  0xe1, 0x71, 0x06, 0xd0, 0x4b, 0xf3, 0x22, 0x04, 0x21, 0x01, 0x65, 0xb2, 0x66, 0x8d, 0x9a, 0xc4,
+  0xaf, 0x06, 0xed, 0x2e, 0xc5, 0x0a, 0x33, 0x32, 0x36, 0x66, 0x17, 0x83, 0x84, 0xf1, 0xf9, 0x98,
+  0xd3, 0xd8, 0x10, 0x18, 0x7f, 0xcd, 0xf2, 0x21, 0x1c, 0xcb, 0x1c, 0x02, 0x3a, 0x49, 0x18, 0x6d,
+  0xe9, 0x8b, 0xb5, 0x8c, 0x87, 0x1a, 0x00, 0xb2, 0x42, 0x4b, 0x71, 0x94, 0xa6, 0xdf, 0x3f, 0xbf,
+  0xaa, 0xa5, 0x73, 0xad, 0xb1, 0x0a, 0x4a, 0x07, 0xb8, 0xae, 0x69, 0x07, 0xc6, 0x02, 0x19, 0x03,
+  0x95, 0xd1, 0xc5, 0xb3, 0xa8, 0xaf, 0x00, 0x10, 0x28, 0xcc, 0x57, 0xfd, 0x59, 0xe6, 0x25, 0x0b,
+  0xa1, 0xee, 0x80, 0xbf, 0x6f, 0x1d, 0xc6, 0x26, 0x7c, 0xe3, 0xec, 0x82, 0xbd, 0xf0, 0x17, 0xbd,
+  0x10, 0x2b, 0x87, 0xff, 0xdf, 0x3b, 0xc4, 0x94, 0x24, 0xb1, 0x09, 0x1f, 0xa2, 0x87, 0xc1, 0xce,
+  0x7f, 0xfe, 0x19, 0x4f, 0xbb, 0x30, 0xd0, 0xf8, 0xd8, 0xc8, 0xe8, 0x30, 0x9f, 0xbc, 0x16, 0x59,
+  0xe5, 0x1f, 0x77, 0x5d, 0x3a, 0x12, 0x16, 0xd7, 0x66, 0x83, 0x31, 0x93, 0xde, 0xf7, 0xcd, 0xe0,
+  0xdb, 0x28, 0xf3, 0x25, 0x06, 0xbf, 0x8e, 0x24, 0x4a, 0xa5, 0xfe, 0xc9, 0xda, 0x5b, 0x2f, 0x4a,
+  0xad, 0xd1, 0x7e, 0xbb, 0x5b, 0x5c, 0xfb, 0xf4, 0xe8, 0xbe, 0x56, 0x92, 0x4a, 0x5d, 0x08, 0x21,
+  0xa2, 0x20, 0xca, 0x91, 0xb2, 0x55, 0xb0, 0xe6, 0x25, 0x3c, 0xae, 0x91, 0x56, 0x46, 0xbd, 0x83,
+  0xe8, 0xf6, 0x26, 0xbd, 0x8b, 0x3a, 0xe0, 0xfd, 0x8b, 0x05, 0xad, 0x50, 0xc7, 0xb1, 0x45, 0x57,
+  0x73, 0x48, 0xde, 0x43, 0x38, 0x08, 0xc2, 0x2d, 0xc5, 0xfc, 0x50, 0x30, 0x6e, 0x4a, 0xec, 0xf9,
+  0x72, 0x98, 0x5e, 0x6f, 0xe5, 0x91, 0x2e, 0x82, 0x64, 0x6f, 0x67, 0x37, 0x20, 0x32, 0x19, 0xda,
+  0x98, 0x18, 0x68, 0xad, 0xb1, 0x13, 0x64, 0x58, 0x82, 0x7b, 0x2d, 0x97, 0x15, 0xfa, 0x89, 0xfb,
+  0x81, 0x4b, 0x05, 0xb5, 0xa7, 0x4e, 0x53, 0xef, 0xf8, 0xdf, 0x5b, 0xd4, 0x2f, 0xc0, 0xd7, 0x92,
+  0x71, 0x68, 0xfd, 0x1e, 0x2c, 0x8c, 0xc2, 0xd8, 0x2b, 0xba, 0x3f, 0xfb, 0x8c, 0x3d, 0xec, 0x63,
+  0x43, 0xe4, 0xcb, 0xb9, 0xb6, 0xaf, 0x15, 0xd2, 0x5d, 0xfb, 0xfc, 0x72, 0x7b, 0xc5, 0x9f, 0x5e,
+  0xe8, 0x25, 0xe9, 0x0f, 0x75, 0x5d, 0xed, 0x18, 0x17, 0xaa, 0x74, 0x01, 0xa2, 0xfc, 0x8b, 0x72,
+  0xe9, 0x77, 0x67, 0x7e, 0xc8, 0x78, 0x7d, 0x9a, 0x91, 0xca, 0x30, 0xa6, 0xd3, 0x88, 0x37, 0xa7,
+  0x11, 0x9f, 0x56, 0x75, 0xab, 0xce, 0x31, 0xde, 0x9e, 0x66, 0xfc, 0x70, 0x74, 0x8e, 0x70, 0x75,
+  0x79, 0x06, 0xb1, 0x3c, 0x8e, 0xe8, 0x66, 0xbf, 0x01, 0x72, 0x09, 0x42, 0x06, 0x4f, 0x04, 0x00,
+  0x00,
+};
+
+// cfgGenJs: 740 bytes uncompressed
+#define cfgGenJs_etag "\"aeb40e385e8ef5d5\""
+static const uint8_t cfgGenJs_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x91, 0xbd, 0x4e, 0xc3, 0x30,
+  0x14, 0x85, 0xf7, 0x3c, 0xc5, 0x25, 0x43, 0x93, 0x2c, 0x51, 0x2b, 0x8a, 0x54, 0x54, 0x99, 0x85,
+  0x95, 0x21, 0x52, 0x11, 0x0b, 0x65, 0x70, 0x92, 0x9b, 0x60, 0xe1, 0xd8, 0xc1, 0x3f, 0xad, 0x10,
+  0xe9, 0xbb, 0x63, 0xc7, 0x6a, 0x29, 0x55, 0x41, 0x65, 0x49, 0x2c, 0xe7, 0xdc, 0x2f, 0xe7, 0x9c,
+  0x1b, 0x35, 0x56, 0x54, 0x86, 0x49, 0x01, 0x46, 0xb6, 0x2d, 0xc7, 0xd5, 0xea, 0x21, 0xd5, 0x9a,
+  0x67, 0x9f, 0x11, 0xc0, 0x86, 0x2a, 0xd8, 0x62, 0xd9, 0x03, 0x81, 0x5a, 0x56, 0xb6, 0x43, 0x61,
+  0xf2, 0x77, 0x8b, 0xea, 0x63, 0x85, 0x1c, 0x2b, 0x23, 0x55, 0x9a, 0x3c, 0x0b, 0xda, 0x21, 0x89,
+  0xbd, 0x2a, 0x7e, 0x49, 0xb2, 0xa5, 0x9b, 0x62, 0x0d, 0x78, 0x42, 0x5e, 0xbd, 0x62, 0xf5, 0x86,
+  0x35, 0x4c, 0x26, 0x23, 0x24, 0xdf, 0x50, 0x6e, 0x11, 0x08, 0x81, 0x64, 0x31, 0x4d, 0xb2, 0x1f,
+  0x77, 0x30, 0x9f, 0x5f, 0x9f, 0x19, 0x25, 0xa4, 0xa1, 0x5c, 0xe3, 0x19, 0x82, 0xd3, 0x9f, 0x22,
+  0x16, 0xd3, 0x65, 0xb4, 0x8b, 0x4e, 0xd2, 0x14, 0x54, 0xeb, 0xb4, 0x77, 0x8f, 0x43, 0x9e, 0xb6,
+  0x67, 0x97, 0x04, 0x1a, 0x65, 0xc7, 0x89, 0x3c, 0x64, 0xef, 0x2b, 0x03, 0x4f, 0x83, 0xc0, 0xca,
+  0x6b, 0xa6, 0x69, 0xc9, 0x5d, 0x50, 0x02, 0xa3, 0x5d, 0x3f, 0xb1, 0x43, 0x77, 0xf8, 0x45, 0x64,
+  0x94, 0x0d, 0x9a, 0x63, 0xbb, 0x2d, 0x8a, 0x27, 0xca, 0x59, 0x4d, 0x0d, 0xa6, 0x01, 0xef, 0xcd,
+  0x36, 0x52, 0x75, 0x7f, 0x78, 0xf5, 0x9f, 0x83, 0x43, 0x2f, 0xa6, 0x75, 0x71, 0xf9, 0xa2, 0x42,
+  0x6d, 0xcb, 0x43, 0x29, 0xc5, 0x3f, 0x2a, 0xf9, 0x9e, 0xf5, 0xc5, 0xb8, 0xdf, 0x12, 0x32, 0x1d,
+  0x06, 0xc7, 0x70, 0x6f, 0x18, 0x06, 0x6f, 0xe4, 0x6e, 0x7e, 0x3b, 0xbb, 0x99, 0x8d, 0x97, 0xe1,
+  0xb8, 0xaf, 0x8c, 0x72, 0x54, 0x26, 0x8d, 0x1f, 0xef, 0x0b, 0xe8, 0xa5, 0x32, 0xc0, 0x34, 0x48,
+  0x6b, 0x40, 0x36, 0xa0, 0xa8, 0x68, 0xf1, 0x6a, 0xbd, 0x16, 0x05, 0x47, 0xea, 0x96, 0xae, 0xd1,
+  0x00, 0x0d, 0xa2, 0xb0, 0xe2, 0x12, 0xcd, 0x16, 0x51, 0xc0, 0x0c, 0xa8, 0xa8, 0x61, 0xa4, 0xe6,
+  0x71, 0x76, 0xd2, 0xb6, 0xaf, 0x24, 0xd7, 0xb6, 0xec, 0x98, 0x49, 0xb3, 0x7d, 0xcb, 0x5f, 0xd1,
+  0x58, 0xfe, 0x71, 0xe4, 0x02, 0x00, 0x00,
+};
+
+// cfgWifiJs: 1852 bytes uncompressed
+#define cfgWifiJs_etag "\"67a091ce69309ea9\""
+static const uint8_t cfgWifiJs_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x55, 0x5d, 0x6b, 0xe2, 0x40,
+  0x14, 0x7d, 0xf7, 0x57, 0xdc, 0xed, 0x43, 0x13, 0x31, 0x48, 0xda, 0xda, 0x52, 0xd0, 0x14, 0x0a,
+  0xdd, 0x05, 0x1f, 0x4a, 0x0b, 0x42, 0xf7, 0xa1, 0xf8, 0x30, 0xc9, 0x5c, 0xeb, 0x68, 0x4c, 0xec,
+  0xcc, 0x44, 0x59, 0xda, 0xfc, 0xf7, 0xce, 0x47, 0x12, 0x47, 0xad, 0x5b, 0x77, 0x17, 0x16, 0x24,
+  0xc4, 0x99, 0x7b, 0xee, 0xb9, 0x73, 0xee, 0xb9, 0x93, 0xd6, 0xa4, 0xc8, 0x12, 0xc9, 0xf2, 0x0c,
+  0xd6, 0x6c, 0xc2, 0xee, 0x73, 0x8a, 0x7e, 0xfb, 0xad, 0x05, 0xb0, 0x22, 0x1c, 0x92, 0xe9, 0x7c,
+  0x01, 0x11, 0xd0, 0x3c, 0x29, 0x16, 0x98, 0xc9, 0xee, 0x6b, 0x81, 0xfc, 0xd7, 0x08, 0x53, 0x4c,
+  0x64, 0xce, 0x7d, 0xef, 0x39, 0x23, 0x0b, 0x8c, 0x4e, 0x54, 0xd4, 0xfd, 0xc9, 0xd8, 0x6b, 0xf7,
+  0x37, 0x28, 0x7a, 0x14, 0xea, 0xce, 0x45, 0xd1, 0x69, 0xb2, 0xfc, 0x1a, 0xa5, 0xa3, 0x5c, 0x54,
+  0x9e, 0x48, 0x94, 0xe2, 0x20, 0xee, 0x36, 0x4d, 0x7d, 0xaf, 0xcb, 0x96, 0x5b, 0x80, 0x14, 0x33,
+  0x05, 0xb0, 0xc8, 0xae, 0xfa, 0xf3, 0x22, 0xa7, 0xf5, 0x2e, 0xd3, 0x2f, 0x6c, 0x02, 0xbe, 0x3e,
+  0x79, 0x37, 0x99, 0x62, 0x32, 0x47, 0x6a, 0xe4, 0x68, 0x96, 0xe9, 0xce, 0x32, 0x80, 0x40, 0xf9,
+  0x90, 0xc8, 0x27, 0x86, 0x6b, 0xdf, 0x26, 0x0d, 0xc2, 0xc0, 0xd2, 0x04, 0x92, 0x17, 0x68, 0xa8,
+  0x01, 0x4a, 0x4c, 0x05, 0xd6, 0x10, 0x93, 0x87, 0x32, 0x41, 0xe2, 0x14, 0xb5, 0x56, 0x13, 0xa2,
+  0x36, 0xfb, 0x5f, 0xe7, 0x33, 0x71, 0x75, 0x42, 0xf3, 0x5c, 0x2f, 0x72, 0xda, 0x5d, 0x91, 0xb4,
+  0x40, 0x95, 0xe6, 0x4c, 0xef, 0x38, 0x44, 0x6e, 0xb9, 0xdb, 0x2c, 0xbb, 0x05, 0xe8, 0x42, 0xed,
+  0xce, 0x67, 0xec, 0xbd, 0x2d, 0xe2, 0xfd, 0x88, 0xde, 0xde, 0x79, 0xcb, 0x56, 0xd9, 0x6a, 0x8c,
+  0xb5, 0x0d, 0x78, 0x88, 0x67, 0x81, 0x08, 0x30, 0x10, 0x92, 0x48, 0xa3, 0xe1, 0x24, 0xe7, 0xe0,
+  0xb3, 0x48, 0xf4, 0x81, 0x0d, 0x50, 0x3d, 0x3a, 0x9d, 0x4a, 0x5a, 0x1b, 0xfc, 0xcc, 0xc6, 0x6e,
+  0xa5, 0x1a, 0xb6, 0xc7, 0xa0, 0xad, 0xfb, 0x44, 0x52, 0x46, 0x89, 0x74, 0xec, 0xab, 0x12, 0xff,
+  0xce, 0xbe, 0x7a, 0x7b, 0x63, 0x0c, 0x14, 0x82, 0x1d, 0x61, 0x5b, 0x13, 0xa6, 0x1d, 0x68, 0x45,
+  0xaf, 0xd1, 0xcb, 0x75, 0xce, 0x8f, 0x40, 0x9b, 0xb0, 0x7d, 0x34, 0x72, 0xae, 0xb0, 0x61, 0x6d,
+  0x3e, 0xc3, 0x11, 0x45, 0x9e, 0xd7, 0x06, 0x2b, 0x04, 0x49, 0x91, 0x4b, 0xdf, 0xfb, 0xc9, 0x7e,
+  0x30, 0xf8, 0x3e, 0x1a, 0x0d, 0xef, 0x80, 0xe3, 0x6b, 0xc1, 0x38, 0xd2, 0x6f, 0x5e, 0xd5, 0x14,
+  0x95, 0xa2, 0xd3, 0xb1, 0xba, 0xd8, 0x24, 0x86, 0xaa, 0xb2, 0xf7, 0xe0, 0x1a, 0xde, 0xdf, 0xc1,
+  0x5d, 0xb9, 0xb9, 0xba, 0xd8, 0x49, 0xfe, 0x48, 0x84, 0x30, 0x87, 0x58, 0x14, 0x42, 0x42, 0x8c,
+  0xea, 0x27, 0xd7, 0xa8, 0x46, 0xe5, 0x1a, 0x48, 0x46, 0xe1, 0xea, 0x42, 0x79, 0x86, 0x70, 0xa2,
+  0x1a, 0xce, 0x05, 0xa4, 0x79, 0xf6, 0x72, 0x98, 0x5a, 0x2d, 0x44, 0x51, 0x08, 0xa7, 0xa7, 0xa6,
+  0x83, 0x73, 0xbf, 0xdd, 0x36, 0xad, 0xe8, 0x8a, 0x22, 0x5e, 0x30, 0xe9, 0x2b, 0x98, 0xd3, 0xba,
+  0x2a, 0xe4, 0xed, 0x6f, 0x07, 0xfa, 0x7f, 0xde, 0x51, 0x2c, 0x0a, 0xeb, 0x57, 0x19, 0xf5, 0x3e,
+  0xbd, 0x2b, 0xe0, 0xc0, 0x65, 0x01, 0x6f, 0x1c, 0x65, 0xc1, 0x33, 0x33, 0x69, 0xa5, 0x15, 0x4e,
+  0x46, 0x7b, 0x97, 0x90, 0x33, 0xbc, 0x15, 0x43, 0xb9, 0x99, 0x90, 0x50, 0x4f, 0x88, 0x74, 0x27,
+  0x44, 0xd3, 0xd8, 0x1c, 0x7a, 0x4a, 0x8c, 0xa7, 0x06, 0xa1, 0xee, 0xf5, 0xce, 0xe2, 0xcd, 0xf9,
+  0xe5, 0x65, 0x5d, 0x5a, 0xd3, 0xf1, 0x61, 0xb6, 0xd2, 0x23, 0x03, 0xc3, 0x47, 0x20, 0x94, 0x72,
+  0xe5, 0xba, 0xa6, 0xa5, 0x00, 0x55, 0xb5, 0xce, 0x95, 0x51, 0x56, 0xc5, 0x38, 0xe7, 0xd8, 0x6d,
+  0xe4, 0x6d, 0x21, 0x73, 0x3f, 0x8f, 0x67, 0xff, 0xf8, 0x01, 0xf9, 0x23, 0x0f, 0x1c, 0xea, 0x80,
+  0xab, 0xd9, 0xd9, 0xb9, 0x15, 0xad, 0x51, 0xc0, 0xe8, 0x16, 0xcf, 0x20, 0x8a, 0x36, 0x4a, 0xb5,
+  0x9b, 0xd7, 0x4e, 0x6f, 0xdc, 0x5c, 0xa9, 0x3b, 0x42, 0xba, 0x52, 0x94, 0xad, 0x0f, 0x39, 0x24,
+  0x10, 0x81, 0x3c, 0x07, 0x00, 0x00,
+};
+
+// cfg488Js: 542 bytes uncompressed
+#define cfg488Js_etag "\"0c508e2a2b878b19\""
+static const uint8_t cfg488Js_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x90, 0xcf, 0x6a, 0xc3, 0x30,
+  0x0c, 0xc6, 0xef, 0x79, 0x0a, 0xd1, 0x4b, 0x92, 0x4b, 0xa0, 0xa5, 0x87, 0x42, 0xe8, 0xa9, 0x8f,
+  0xb0, 0xe3, 0xd8, 0x41, 0xb1, 0xe5, 0xcc, 0xd4, 0x7f, 0x52, 0x47, 0x0e, 0x94, 0x91, 0x77, 0x9f,
+  0xdd, 0x36, 0x65, 0x87, 0x6e, 0xb4, 0xec, 0x22, 0x04, 0xfa, 0x7e, 0xfa, 0xa4, 0xaf, 0x50, 0xd1,
+  0x09, 0xd6, 0xde, 0x01, 0xfb, 0xbe, 0x37, 0x74, 0xb0, 0x5e, 0x52, 0x25, 0x72, 0xad, 0xbf, 0x0a,
+  0x80, 0x09, 0x03, 0x60, 0x64, 0x0f, 0x7b, 0x90, 0x5e, 0x44, 0x4b, 0x8e, 0x9b, 0x53, 0xa4, 0x70,
+  0x7e, 0x23, 0x43, 0x82, 0x7d, 0xa8, 0x4a, 0xed, 0x86, 0xc8, 0xef, 0x0e, 0x2d, 0xed, 0x57, 0x59,
+  0xba, 0xfa, 0x28, 0xeb, 0xf6, 0x86, 0x06, 0xb6, 0xcf, 0xa2, 0x81, 0x50, 0x26, 0xf5, 0x42, 0x6b,
+  0x05, 0xd7, 0x33, 0x1a, 0xf1, 0x49, 0xe2, 0x48, 0xb2, 0x86, 0x7c, 0x4f, 0x36, 0x68, 0xa4, 0x1e,
+  0xb1, 0x33, 0x24, 0xd3, 0x66, 0x85, 0x66, 0xa4, 0xac, 0x87, 0x8b, 0xd7, 0xc3, 0xd1, 0x4c, 0xa9,
+  0x79, 0x04, 0x73, 0x88, 0xbf, 0xb0, 0xcb, 0x64, 0x2e, 0xe6, 0xe2, 0x9e, 0x10, 0x0e, 0x83, 0x39,
+  0x6f, 0x77, 0xbb, 0x83, 0xea, 0xab, 0x4b, 0x38, 0xcf, 0xbc, 0xe5, 0x07, 0xce, 0x2f, 0x35, 0x13,
+  0x9a, 0x48, 0x69, 0xf3, 0xba, 0xfd, 0x03, 0x54, 0x3e, 0xd8, 0xa4, 0x1d, 0x63, 0x67, 0x35, 0x57,
+  0x29, 0x87, 0x1f, 0xee, 0x23, 0x4e, 0xf4, 0x5f, 0xf3, 0xcd, 0x8b, 0xe6, 0xdf, 0xf7, 0x65, 0x81,
+  0x81, 0x1e, 0x02, 0x00, 0x00,
+};
+
+// cfgAdmJs: 1648 bytes uncompressed
+#define cfgAdmJs_etag "\"04eff9a1a208b917\""
+static const uint8_t cfgAdmJs_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x54, 0x4d, 0x6f, 0xdb, 0x30,
+  0x0c, 0xbd, 0xe7, 0x57, 0x70, 0xde, 0x21, 0x36, 0x10, 0x18, 0xb3, 0x53, 0x0c, 0x59, 0x0b, 0x63,
+  0x08, 0xd0, 0x0d, 0xeb, 0x65, 0x0b, 0x9a, 0x01, 0x3b, 0xa4, 0x39, 0x28, 0x36, 0xdd, 0x68, 0x95,
+  0xa5, 0x54, 0x92, 0x63, 0x14, 0x6b, 0xfe, 0xfb, 0x44, 0x7f, 0xe4, 0x0b, 0x6b, 0x32, 0x0c, 0xeb,
+  0xc5, 0x21, 0x44, 0xbe, 0xc7, 0xc7, 0x47, 0x45, 0xbd, 0xbc, 0x94, 0xa9, 0xe5, 0x4a, 0x42, 0xba,
+  0xbc, 0x9f, 0x54, 0x99, 0x5f, 0x98, 0xfb, 0xe0, 0x57, 0x0f, 0x60, 0xcd, 0x34, 0xac, 0xaa, 0x2c,
+  0x82, 0x04, 0x32, 0x95, 0x96, 0x05, 0x4a, 0x1b, 0x3e, 0x96, 0xa8, 0x9f, 0xa6, 0x28, 0x30, 0xb5,
+  0x4a, 0xfb, 0xfd, 0xb7, 0x94, 0xef, 0x07, 0xe1, 0x9a, 0x89, 0x12, 0xaf, 0x76, 0x98, 0xf8, 0x0c,
+  0x26, 0xfe, 0x03, 0x66, 0x78, 0x06, 0x33, 0xdc, 0xc7, 0xf0, 0x1c, 0x7c, 0xea, 0x9d, 0x24, 0x9e,
+  0xf7, 0xfc, 0x4c, 0x8c, 0xdb, 0x68, 0x48, 0x51, 0x00, 0x34, 0x01, 0x00, 0x13, 0xa8, 0xad, 0xef,
+  0x4d, 0x98, 0x31, 0x95, 0xd2, 0x99, 0x81, 0x94, 0x49, 0xa9, 0x2c, 0x2c, 0x10, 0x16, 0x82, 0xc9,
+  0x87, 0x37, 0x5e, 0x70, 0x55, 0x17, 0x6a, 0xb4, 0xa5, 0x96, 0x14, 0x6f, 0x0e, 0xe8, 0xe9, 0x27,
+  0x6e, 0x78, 0x83, 0xe0, 0x80, 0xf3, 0x2b, 0x56, 0xb0, 0x6a, 0x79, 0xf7, 0x68, 0xed, 0x12, 0xc1,
+  0xb0, 0x02, 0x81, 0x99, 0x3a, 0x56, 0x22, 0xdb, 0x96, 0x9d, 0xee, 0xe6, 0x46, 0xa8, 0xdb, 0x34,
+  0x5d, 0x74, 0x29, 0xc7, 0x59, 0x71, 0x8b, 0x8f, 0xb5, 0x90, 0x01, 0xe5, 0x07, 0x51, 0x0d, 0xdf,
+  0xa0, 0x30, 0xf8, 0xa2, 0x14, 0xe3, 0x4c, 0x04, 0xd2, 0x52, 0x30, 0x9b, 0x2e, 0xdb, 0x8e, 0x9b,
+  0xde, 0xa6, 0xb7, 0x5d, 0xb3, 0x36, 0xf6, 0x3a, 0x17, 0xd6, 0xff, 0xe7, 0x25, 0x77, 0xee, 0xb4,
+  0x4a, 0x89, 0x42, 0xa3, 0x71, 0x0c, 0xa9, 0x92, 0x39, 0xd7, 0x85, 0xef, 0x7d, 0x77, 0x83, 0x73,
+  0x69, 0x51, 0xe7, 0x2c, 0x45, 0xa8, 0xb8, 0x10, 0x64, 0x8d, 0x2b, 0x42, 0x0b, 0x56, 0x41, 0x86,
+  0x39, 0x2b, 0x85, 0x85, 0xf1, 0x04, 0x0a, 0x95, 0x21, 0xf8, 0x9f, 0xa6, 0xd3, 0x9b, 0xeb, 0x4b,
+  0x18, 0xdf, 0x5e, 0x8c, 0x46, 0x15, 0xcf, 0xf9, 0x00, 0x6e, 0x26, 0xc0, 0xb2, 0xcc, 0x21, 0xcc,
+  0x25, 0x44, 0x1f, 0xe2, 0x30, 0x7a, 0x3f, 0x0a, 0x2f, 0xc2, 0xd1, 0x28, 0x08, 0xef, 0xee, 0xe4,
+  0x58, 0x23, 0x3c, 0xa9, 0x12, 0x4c, 0xd9, 0x06, 0x15, 0x37, 0x4b, 0x22, 0x5e, 0x69, 0x95, 0x22,
+  0x66, 0x1f, 0x3b, 0x9f, 0x49, 0xa9, 0xe3, 0x08, 0x8e, 0xdd, 0xf4, 0xbc, 0x41, 0xfc, 0x82, 0x97,
+  0x13, 0x81, 0xcc, 0x60, 0x37, 0x4a, 0xbd, 0xc2, 0xb4, 0xd4, 0xda, 0xf9, 0xe2, 0x04, 0x15, 0x5c,
+  0x1e, 0x2f, 0xf3, 0xd0, 0x5a, 0x5c, 0x28, 0xf5, 0xea, 0xce, 0xfe, 0xe0, 0x9f, 0x39, 0x9d, 0x48,
+  0x6c, 0xba, 0x76, 0xfe, 0xd6, 0x8e, 0xeb, 0x72, 0x65, 0x31, 0x0b, 0xe1, 0x7f, 0x78, 0x34, 0x7c,
+  0x15, 0x8f, 0x0e, 0xdb, 0xd4, 0xcf, 0xc5, 0x00, 0x58, 0x6a, 0x77, 0xae, 0xe9, 0x82, 0x5c, 0x9b,
+  0x7e, 0x19, 0x47, 0x8d, 0x1b, 0x57, 0xbb, 0x44, 0xbc, 0x97, 0x88, 0xf7, 0x13, 0xf4, 0x7c, 0x4c,
+  0xb4, 0x2a, 0xb8, 0xc1, 0xd0, 0x8d, 0xa3, 0xc4, 0x1a, 0x7d, 0x22, 0xa5, 0x92, 0xee, 0x9c, 0x09,
+  0xe1, 0xcf, 0x88, 0x7d, 0x40, 0x4c, 0xf4, 0x19, 0xce, 0x83, 0xd0, 0xc9, 0x97, 0x7e, 0x27, 0x8f,
+  0xac, 0x70, 0x57, 0xd3, 0xb4, 0x1b, 0xc8, 0x95, 0x2e, 0xbe, 0x2d, 0x7e, 0x9e, 0xd8, 0x21, 0x55,
+  0xf4, 0x5b, 0x2b, 0x49, 0x4a, 0xba, 0x7c, 0x38, 0xb5, 0xf2, 0x99, 0x74, 0x6f, 0x43, 0xe2, 0x51,
+  0x95, 0x37, 0x3f, 0xc2, 0xc5, 0x7f, 0x85, 0x8b, 0x0f, 0x71, 0x6a, 0x65, 0xcf, 0xc3, 0x5c, 0xd1,
+  0x0e, 0x45, 0xbd, 0x9b, 0x2b, 0xe7, 0x80, 0xed, 0xb8, 0xb3, 0x77, 0xf3, 0x83, 0xdb, 0x50, 0x9f,
+  0xc5, 0xf3, 0x24, 0x89, 0x82, 0x5a, 0x59, 0x53, 0x9f, 0x74, 0x99, 0xa8, 0xad, 0x76, 0xbc, 0x47,
+  0x99, 0xb8, 0xcd, 0xb4, 0xc6, 0x85, 0xa6, 0x5c, 0x14, 0xdc, 0xfd, 0x23, 0xea, 0x6b, 0xe0, 0xbe,
+  0x9b, 0xde, 0x6f, 0x0c, 0xcf, 0xf5, 0xd9, 0x70, 0x06, 0x00, 0x00,
+};
+
+// SHA1funcJs: 3550 bytes uncompressed
+#define SHA1funcJs_etag "\"69d7e955c19e1cec\""
+static const uint8_t SHA1funcJs_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x57, 0xdd, 0x73, 0x9b, 0x38,
+  0x10, 0x7f, 0xcf, 0x5f, 0xa1, 0xeb, 0x4c, 0x5c, 0x71, 0xe0, 0x14, 0x09, 0x8c, 0xf1, 0x05, 0x7b,
+  0x86, 0x0f, 0x67, 0xf2, 0x70, 0x6f, 0x9d, 0x9b, 0x3e, 0x34, 0x1f, 0x43, 0x28, 0x8e, 0x49, 0x09,
+  0xce, 0x00, 0xb1, 0xd3, 0xb9, 0x73, 0xff, 0xf6, 0xae, 0x04, 0x92, 0x85, 0x4d, 0xa6, 0x6e, 0x1e,
+  0xae, 0x9e, 0x31, 0x5e, 0xad, 0x76, 0x57, 0xbf, 0xdf, 0xee, 0x4a, 0xc8, 0x27, 0x8b, 0xe7, 0x22,
+  0xa9, 0xb3, 0x55, 0x81, 0x3e, 0x5e, 0xfa, 0x04, 0x3f, 0x56, 0xf7, 0xda, 0xbf, 0x27, 0x08, 0x49,
+  0x6d, 0xb9, 0xaa, 0xe3, 0x3a, 0xbd, 0xcd, 0xd3, 0x45, 0x8d, 0x0b, 0xa3, 0xe2, 0x93, 0xec, 0xb3,
+  0x8e, 0x4b, 0x54, 0xdb, 0x68, 0x8a, 0x70, 0xe1, 0x79, 0x95, 0x86, 0xfe, 0x03, 0x61, 0x36, 0x9b,
+  0x61, 0x8b, 0x0e, 0x2b, 0x4d, 0x3b, 0x6f, 0xad, 0xca, 0xb4, 0x7e, 0x2e, 0x0b, 0x30, 0x64, 0x8a,
+  0xed, 0xb9, 0x1a, 0x38, 0xaf, 0xee, 0x6e, 0x97, 0xe9, 0x0b, 0x5e, 0xc7, 0xb9, 0x86, 0x9a, 0xa8,
+  0x2c, 0x66, 0x55, 0x97, 0xd3, 0xf7, 0xef, 0xcf, 0xe5, 0x38, 0xdb, 0x89, 0xeb, 0xa5, 0x22, 0xe7,
+  0x8d, 0xbc, 0x58, 0x95, 0x18, 0x65, 0x53, 0xf3, 0x1c, 0x65, 0xde, 0xd4, 0x81, 0xa7, 0x3e, 0xa5,
+  0x68, 0x07, 0x72, 0xc9, 0x00, 0xc2, 0x0a, 0x0c, 0x59, 0xf6, 0xa7, 0xad, 0xdb, 0x9a, 0x36, 0x30,
+  0x5f, 0xcc, 0x85, 0xc0, 0xb7, 0xce, 0xbb, 0x06, 0x7b, 0xd3, 0x00, 0x06, 0xe9, 0x53, 0x08, 0x73,
+  0x56, 0xaf, 0x3e, 0xd6, 0x65, 0x56, 0xdc, 0x63, 0xe2, 0x68, 0x48, 0x07, 0xbf, 0x8e, 0xa6, 0xb1,
+  0xdf, 0x9e, 0x28, 0x94, 0xc1, 0xf5, 0x90, 0x73, 0xb2, 0xae, 0x25, 0xe7, 0xe3, 0x28, 0x77, 0x58,
+  0x8e, 0x81, 0xdf, 0x8c, 0x73, 0x1d, 0x0e, 0x91, 0x48, 0x1a, 0x18, 0x1e, 0xc5, 0xe1, 0x4d, 0x80,
+  0xff, 0xa9, 0x17, 0xee, 0xbc, 0x48, 0x56, 0x5f, 0x52, 0x5c, 0x71, 0x67, 0xb5, 0x54, 0xcf, 0xf5,
+  0xa2, 0x4e, 0x5f, 0x6a, 0x58, 0x5d, 0xa0, 0x6f, 0x6c, 0x40, 0xd1, 0x08, 0x67, 0x65, 0xfa, 0x94,
+  0xc7, 0x49, 0x8a, 0x3f, 0x5c, 0x5d, 0x95, 0x57, 0x57, 0xc5, 0x87, 0x7b, 0xe3, 0x1d, 0xfc, 0xbc,
+  0xd3, 0x24, 0x2b, 0x86, 0xbb, 0x44, 0x05, 0x78, 0x00, 0xab, 0x02, 0x79, 0xc2, 0x31, 0x4f, 0x8b,
+  0xfb, 0x7a, 0x09, 0x2a, 0x5d, 0xef, 0x74, 0x5c, 0xb2, 0x8b, 0x9d, 0x2c, 0xe3, 0x32, 0x04, 0x60,
+  0x3e, 0xf4, 0xa5, 0xec, 0xb7, 0x6c, 0x81, 0x70, 0x02, 0x61, 0x08, 0x75, 0x77, 0xf9, 0x41, 0x12,
+  0x29, 0xe4, 0xa1, 0xc9, 0xc1, 0xd9, 0xa2, 0x5c, 0x3d, 0x86, 0x6d, 0x04, 0x9c, 0x48, 0xff, 0x6d,
+  0x9a, 0x57, 0x29, 0x44, 0xc1, 0x10, 0x65, 0x06, 0x51, 0xc6, 0xda, 0x60, 0xc0, 0x03, 0x52, 0xd3,
+  0x76, 0xb5, 0x5f, 0x08, 0xc9, 0xfc, 0x67, 0xc8, 0x61, 0xfb, 0x82, 0x4c, 0xa8, 0x8c, 0x7f, 0x8c,
+  0xdf, 0x00, 0x39, 0x16, 0xf7, 0x03, 0x0e, 0x1d, 0x5c, 0xbb, 0xc5, 0x8f, 0x5b, 0x9d, 0x50, 0x16,
+  0x86, 0x52, 0x5b, 0x59, 0xfe, 0xa7, 0x9e, 0x12, 0x78, 0x1f, 0x8c, 0xb7, 0xe3, 0x3f, 0xec, 0xb7,
+  0x36, 0x90, 0xec, 0x39, 0x56, 0xde, 0xbb, 0x7c, 0x95, 0x7c, 0xad, 0xea, 0xb8, 0xac, 0x85, 0x26,
+  0x33, 0xd0, 0x83, 0x90, 0x3f, 0x41, 0xf1, 0x8b, 0x74, 0x83, 0xfc, 0xb2, 0x8c, 0xbf, 0x61, 0xd7,
+  0xd4, 0xc4, 0xc4, 0xa5, 0xc9, 0x1a, 0xe8, 0xc5, 0x19, 0xdb, 0x23, 0x6a, 0x99, 0x44, 0xaa, 0x09,
+  0x57, 0xcf, 0x2f, 0xc2, 0xc8, 0x0f, 0xdc, 0x89, 0x54, 0x53, 0xae, 0x9e, 0xb8, 0x81, 0x1f, 0x85,
+  0x17, 0x73, 0xa9, 0xb6, 0xb8, 0x9a, 0x98, 0x16, 0x1d, 0xd9, 0x63, 0x47, 0xaa, 0x6d, 0xae, 0x0e,
+  0xad, 0x88, 0xce, 0xc9, 0x85, 0x29, 0xd4, 0xbe, 0x11, 0x18, 0xa1, 0x11, 0x19, 0xd2, 0xbd, 0x4e,
+  0x1f, 0x9f, 0x98, 0x0c, 0x07, 0x28, 0x38, 0x28, 0xfb, 0x86, 0x9d, 0xa8, 0xc2, 0x08, 0x64, 0x38,
+  0x49, 0x59, 0xbb, 0x83, 0x24, 0x9a, 0xbc, 0x9d, 0xdb, 0xac, 0xca, 0x2f, 0xb7, 0x31, 0xa3, 0xd6,
+  0xa1, 0xc9, 0x7d, 0xd5, 0x53, 0xae, 0x8d, 0x31, 0xb4, 0xf8, 0x61, 0x67, 0xcb, 0x73, 0xe0, 0xa1,
+  0x8d, 0xaa, 0xec, 0x8b, 0x4c, 0xf3, 0x3c, 0x6a, 0x43, 0x29, 0xf6, 0xf5, 0x3a, 0x81, 0x19, 0xe2,
+  0xf4, 0xcd, 0x50, 0x98, 0x71, 0xfb, 0x26, 0xac, 0xb6, 0x98, 0x3b, 0x9c, 0x67, 0x4f, 0xcf, 0xd5,
+  0x12, 0x3f, 0x70, 0x3d, 0x2b, 0x6d, 0xb5, 0xc9, 0xea, 0x64, 0x89, 0x05, 0xc9, 0x53, 0x64, 0xb7,
+  0x7b, 0x37, 0x89, 0x61, 0x53, 0x99, 0x7f, 0x89, 0x3d, 0xca, 0x13, 0x6a, 0xba, 0x66, 0xf3, 0x11,
+  0x2d, 0x72, 0x57, 0xa6, 0xf1, 0xd7, 0xf3, 0x9d, 0x3d, 0x51, 0xed, 0xf7, 0xd0, 0x88, 0x1c, 0x10,
+  0x41, 0x50, 0xc6, 0x7b, 0x2d, 0x1a, 0x3d, 0x22, 0x1a, 0x7d, 0x25, 0x5d, 0xea, 0x6a, 0x3c, 0x69,
+  0xed, 0x6a, 0xaf, 0xad, 0x65, 0x1d, 0xb1, 0x96, 0xf5, 0x93, 0xb5, 0xe8, 0x2b, 0x05, 0x52, 0xb1,
+  0xb8, 0x1c, 0x8a, 0x7b, 0x88, 0x83, 0x15, 0x63, 0xbf, 0x4c, 0x19, 0x2f, 0xd3, 0x66, 0x99, 0xe5,
+  0x29, 0x46, 0x58, 0x99, 0x6d, 0xba, 0x10, 0x9d, 0x9e, 0x22, 0xf6, 0x6a, 0xfb, 0x63, 0x8a, 0x88,
+  0xad, 0x1d, 0x78, 0x37, 0x7b, 0x6d, 0x5f, 0xdb, 0x82, 0x81, 0xf7, 0x0e, 0x9d, 0xf4, 0x1a, 0x08,
+  0x0b, 0xcf, 0xb3, 0x9a, 0x97, 0x52, 0xfb, 0x11, 0x4d, 0x8d, 0xb0, 0xb2, 0xe5, 0x59, 0x7b, 0xef,
+  0x46, 0xde, 0x01, 0x44, 0x75, 0x56, 0x9f, 0x42, 0x72, 0xda, 0xee, 0x52, 0x37, 0x07, 0xe1, 0x57,
+  0x00, 0x1d, 0x36, 0xc5, 0xa7, 0xcf, 0xd9, 0x35, 0xa4, 0x7f, 0x17, 0xe5, 0xb3, 0xe2, 0x9d, 0x5d,
+  0x77, 0xde, 0xab, 0xdc, 0xcb, 0x9b, 0x8e, 0x27, 0x7b, 0xce, 0xea, 0xdd, 0x07, 0x54, 0x43, 0xeb,
+  0x1a, 0xdd, 0xb0, 0xb9, 0xa1, 0x2b, 0x04, 0x62, 0x4b, 0xc9, 0xb9, 0x36, 0x48, 0xbb, 0x45, 0x7c,
+  0xf0, 0xbd, 0x6c, 0xcb, 0x12, 0x30, 0x99, 0x34, 0x72, 0xc8, 0x64, 0xda, 0xc8, 0x11, 0x93, 0xad,
+  0x46, 0x9e, 0x33, 0xd9, 0xee, 0x40, 0x42, 0xcd, 0x8d, 0x86, 0x34, 0x90, 0xe4, 0x3b, 0x90, 0x9d,
+  0x32, 0xec, 0x6d, 0xaf, 0x22, 0xf3, 0x8d, 0x11, 0xbb, 0x92, 0x60, 0x1c, 0x0c, 0x42, 0x7e, 0x0f,
+  0xfb, 0x1e, 0x0c, 0x22, 0x8d, 0xa9, 0xe6, 0xf0, 0xe5, 0x54, 0x74, 0xe8, 0x93, 0x91, 0xef, 0xd2,
+  0xf1, 0x64, 0x32, 0x61, 0x27, 0xbb, 0x52, 0x0a, 0xd1, 0x3c, 0x0c, 0x43, 0x24, 0x06, 0x0c, 0x5c,
+  0x28, 0x06, 0xe1, 0x5e, 0x26, 0x02, 0xc3, 0x32, 0xe5, 0xc1, 0xce, 0xe8, 0xf9, 0x62, 0xc0, 0x78,
+  0x8b, 0x73, 0x50, 0x9c, 0xf6, 0x2d, 0x1f, 0xda, 0xf0, 0xb1, 0x44, 0x8a, 0x8f, 0x21, 0x14, 0xdc,
+  0x84, 0x37, 0xd1, 0x01, 0x0f, 0x67, 0x1e, 0x4d, 0xe6, 0x81, 0x4f, 0x7e, 0x0f, 0x0f, 0xbb, 0xe1,
+  0x31, 0xfa, 0x15, 0x1e, 0xb2, 0x30, 0xac, 0x2e, 0xec, 0x37, 0xec, 0xab, 0x8f, 0x7b, 0x41, 0x82,
+  0x20, 0x8c, 0xc2, 0xdf, 0xc3, 0xcb, 0x31, 0xbb, 0x5b, 0xe0, 0xed, 0xf5, 0x09, 0x7d, 0x87, 0x86,
+  0x24, 0x72, 0xfe, 0x67, 0x1e, 0xfc, 0x0e, 0x80, 0xe1, 0xa9, 0x23, 0xbf, 0x77, 0x69, 0x7e, 0x1b,
+  0xc0, 0xf0, 0xd4, 0x51, 0xd0, 0x6f, 0x40, 0xb9, 0x01, 0x05, 0x83, 0xfe, 0x22, 0xf0, 0x1b, 0x02,
+  0x86, 0xa7, 0x8e, 0xa2, 0x7e, 0x03, 0xfe, 0x7f, 0x08, 0x9e, 0x90, 0x92, 0x1e, 0x83, 0xad, 0x72,
+  0x55, 0x00, 0x43, 0xf1, 0x67, 0xe0, 0xd2, 0x64, 0x39, 0x94, 0x23, 0xd2, 0x19, 0xd1, 0xce, 0xc8,
+  0xea, 0x8c, 0x9a, 0x7b, 0x9d, 0xf8, 0x8b, 0x05, 0x41, 0xe1, 0x8a, 0xff, 0xf7, 0x6a, 0x93, 0x96,
+  0x21, 0xbc, 0x85, 0xd8, 0xc5, 0x61, 0x7b, 0xf2, 0x03, 0xe1, 0x2d, 0x66, 0x3b, 0xde, 0x0d, 0x00,
+  0x00,
+};
+
+#define ASSET_VER "f3e5f795"
+
+#endif  // AR488_ESP8266_ASSETS_H
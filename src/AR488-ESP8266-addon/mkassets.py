@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+#
+# Generate AR488-ESP8266-assets.h from the static web assets in
+# AR488-ESP8266-addon.ino
+#
+# Each asset is gzip compressed and stored in PROGMEM along with an ETag.
+# Run this script again after changing any of the assets listed below.
+#
+
+import gzip
+import hashlib
+import os
+import re
+
+ASSETS = [
+    "cfgAdmPage",
+    "css",
+    "lnkScriptJs",
+    "cfgGenJs",
+    "cfgWifiJs",
+    "cfg488Js",
+    "cfgAdmJs",
+    "SHA1funcJs",
+]
+
+here = os.path.dirname(os.path.abspath(__file__))
+src = os.path.join(here, "AR488-ESP8266-addon.ino")
+dst = os.path.join(here, "AR488-ESP8266-assets.h")
+
+with open(src, "r", encoding="utf-8") as f:
+    sketch = f.read()
+
+out = [
+    "/*",
+    " * Compressed web assets - generated by mkassets.py, do not edit.",
+    " */",
+    "",
+    "#ifndef AR488_ESP8266_ASSETS_H",
+    "#define AR488_ESP8266_ASSETS_H",
+    "",
+]
+
+allhash = hashlib.sha1()
+
+for name in ASSETS:
+    m = re.search(r'static const char ' + name + r'\[\] PROGMEM = R"EOF\((.*?)\)EOF";', sketch, re.S)
+    if not m:
+        raise SystemExit("Asset not found: " + name)
+    text = m.group(1).encode("utf-8")
+    data = gzip.compress(text, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(text).hexdigest()[:16]
+    allhash.update(text)
+    print("%-12s %6d -> %5d bytes" % (name, len(text), len(data)))
+
+    out.append("// %s: %d bytes uncompressed" % (name, len(text)))
+    out.append('#define %s_etag "\\"%s\\""' % (name, etag))
+    out.append("static const uint8_t %s_gz[] PROGMEM = {" % name)
+    for i in range(0, len(data), 16):
+        out.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+
+out.append('#define ASSET_VER "%s"' % allhash.hexdigest()[:8])
+out.append("")
+out.append("#endif  // AR488_ESP8266_ASSETS_H")
+
+with open(dst, "w", encoding="utf-8", newline="\n") as f:
+    f.write("\n".join(out) + "\n")
@@ -24,37 +24,15 @@
 #include "AR488_Eeprom.h"
 #include "AR488_cmd.h"
 #include "AR488_help.h"
+#include "AR488_Macro.h"
+#include "AR488_Trace.h"
+#include "AR488_SimBus.h"
+#ifdef AR488_USBTMC
+  #include "AR488_USBTMC.h"
+#endif
 
-#define PBSIZE 256
+#define PBSTREAM 64   // Data lines are passed to the GPIB bus in parts of this size
 
-#ifdef USE_MACROS
-/***** STARTUP MACRO *****/
-const char startup_macro[] PROGMEM = {MACRO_0};
-
-/***** Consts holding USER MACROS 1 - 9 *****/
-const char macro_1 [] PROGMEM = {MACRO_1};
-const char macro_2 [] PROGMEM = {MACRO_2};
-const char macro_3 [] PROGMEM = {MACRO_3};
-const char macro_4 [] PROGMEM = {MACRO_4};
-const char macro_5 [] PROGMEM = {MACRO_5};
-const char macro_6 [] PROGMEM = {MACRO_6};
-const char macro_7 [] PROGMEM = {MACRO_7};
-const char macro_8 [] PROGMEM = {MACRO_8};
-const char macro_9 [] PROGMEM = {MACRO_9};
-
-const char * const macros[] PROGMEM = {
-  startup_macro,
-  macro_1,
-  macro_2,
-  macro_3,
-  macro_4,
-  macro_5,
-  macro_6,
-  macro_7,
-  macro_8,
-  macro_9
-};
-#endif
 
 #define OK 0
 #define ERR 1
@@ -66,7 +44,7 @@ const char * const macros[] PROGMEM = {
 #define PLUS 0x2B   // '+' character
 
 char pBuf[PBSIZE];
-uint8_t pbPtr = 0;
+uint16_t pbPtr = 0;
 
 GPIBbus gpibBus;
 
@@ -75,46 +53,182 @@ GPIBbus gpibBus;
 // GPIB data receive flags
 bool autoRead = false;              // Auto reading (auto mode 3) GPIB data in progress
 bool readWithEoi = false;           // Read eoi requested
-bool readWithEndByte = false;       // Read with specified terminator character
+bool readBlock = false;             // Read an IEEE 488.2 definite length block
 bool isQuery = false;               // Direct instrument command is a query
-uint8_t tranBrk = 0;                // Transmission break on 1=++, 2=EOI, 3=ATN 4=UNL
-uint8_t endByte = 0;                // Termination character
-bool dataBufferFull = false;        // Flag when parse buffer is full
+readTerm rdTerm;                    // Terminator sequence and byte count given with ++read
+bool dataBufferFull = false;        // Flag when parse buffer holds part of a longer line
+bool isLinePart = false;            // Part of the current data line has already been sent
+char linePartEnd = 0;               // Last character of the part(s) already sent
 
 bool isEsc = false;           // Charcter escaped
 bool isPlusEscaped = false;   // Plus escaped
 bool isVerbose = false;       // Verbose mode
 uint8_t lnRdy = 0;            // Input line ready to process
-bool isRO = false;            // Read only mode flag
+uint8_t isRO = 0;             // Read only mode flag (1=raw bytes, 2=binary capture frames)
 uint8_t isTO = 0;             // Talk only mode flag
 bool isProm = false;          // Pomiscuous mode
-bool isSrqa = false;          // SRQ auto mode
+uint8_t isSrqa = 0;           // SRQ auto mode (1=poll on SRQ, 2=interrupt latched notification, 3=parallel poll)
+#define SRQ_RECHECK_MS 1000   // ++srqauto 2: interval between polls while SRQ stays asserted
+unsigned long srqLast = 0;    // millis() at the end of the last SRQ notification
 bool sendIdn = false;         // Send response to *idn?
 
 uint8_t runMacro = 0;         // Whether to run Macro 0 (macros must be enabled)
 
+#ifdef USE_CAPTURE
+// Bus capture (++lon 2) ring buffer
+#define CAP_BATCH 16        // Records to collect before sending a frame
+#define CAP_IDLE_US 2000    // Send a part frame after this long without traffic
+#define CAP_SYNC 0xA5       // First byte of each frame
+
+#define CAP_ATN 0x01        // Byte was a command (ATN asserted)
+#define CAP_EOI 0x02        // EOI was asserted with the byte
+#define CAP_SRQ 0x04        // SRQ was asserted
+#define CAP_DTOVF 0x08      // Delta time exceeded 65535us
+
+struct capRec {
+  uint8_t db;               // Data byte
+  uint8_t flags;            // CAP_xxx flags
+  uint16_t dt;              // Microseconds since the previous byte
+};
+
+// The ring indices are uint8_t and wrap with a mask
+static_assert((CAP_SIZE > 0) && (CAP_SIZE <= 128) && ((CAP_SIZE & (CAP_SIZE - 1)) == 0), "CAP_SIZE must be a power of 2 no larger than 128 (see AR488_Config.h)");
+
+struct capRec capBuf[CAP_SIZE];
+#define CAP_RAM sizeof(capBuf)
+#else
+#define CAP_RAM 0
+#endif  // USE_CAPTURE
+
+#ifdef TRACE_ENABLE
+  #define TRACE_RAM (TRACE_SIZE * sizeof(traceRec))
+#else
+  #define TRACE_RAM 0
+#endif
+#ifdef AR488_USBTMC
+  #define TMC_RAM USBTMC_BUF_SIZE
+#else
+  #define TMC_RAM 0
+#endif
+static_assert((PBSIZE + GPIB_RXBUF_SIZE + CAP_RAM + TRACE_RAM + TMC_RAM) <= IO_BUDGET, "I/O buffers exceed IO_BUDGET (see AR488_Config.h)");
+
+// Periodic acquisition (++repeat) scheduler
+#define SCHED_QSIZE 64
+char schedQuery[SCHED_QSIZE];   // Query sent to each address every period
+uint8_t schedAddrs[15];         // Addresses to query (none set = current address)
+uint8_t schedAddrCnt = 0;       // Number of addresses in schedAddrs
+uint16_t schedCount = 0;        // Repetitions remaining (0 = until stopped)
+bool schedRun = false;          // Scheduler is running
+unsigned long schedPeriod = 0;  // Sample period in microseconds
+unsigned long schedNext = 0;    // micros() time of the next sample
+
 void flushPbuf() {
   memset(pBuf, '\0', PBSIZE);
   pbPtr = 0;
+  // Buffer is free - let the host send more
+  DATAPORT_READY(true);
 }
 
 void showPrompt() {
-  dataPort.print("> ");
+  dataPort.print(F("> "));
 }
 
-void sendToInstrument(char *buffr, uint8_t dsize) {
-  if (buffr[dsize-1] == '?') isQuery = true;
-  if (!gpibBus.haveAddressedDevice()) gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN);
-
-  gpibBus.sendData(buffr, dsize);
+/***** Send the parse buffer to the instrument *****/
+/*
+ * When the buffer holds only part of a line (dataBufferFull) the part is written
+ * straight away while the rest of the line is still arriving and the instrument
+ * is left addressed. Returns true once the whole line has been sent.
+ */
+bool sendToInstrument(char *buffr, uint16_t dsize) {
+  bool complete = !dataBufferFull;
 
-  if (dataBufferFull) dataBufferFull = false;
-  else gpibBus.unAddressDevice();
+  if (!gpibBus.haveAddressedDevice()) gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN);
 
-  if (isVerbose) showPrompt();
+  if (complete) {
+    if (dsize) linePartEnd = buffr[dsize-1];
+    if ((dsize || isLinePart) && linePartEnd == '?') isQuery = true;
+    isLinePart = false;
+    gpibBus.sendData(buffr, dsize);
+    gpibBus.unAddressDevice();
+    if (isVerbose) showPrompt();
+  } else {
+    dataBufferFull = false;
+    isLinePart = true;
+    linePartEnd = buffr[dsize-1];
+    gpibBus.sendDataPart(buffr, dsize);
+  }
 
   flushPbuf();
   lnRdy = 0;
+  return complete;
+}
+
+/***** Binary write (++wrb) *****/
+/*
+ * ++wrb <len> addresses the instrument to listen and the next len bytes from
+ * the host are written straight to the bus, with EOI on the last byte. They are
+ * not parsed, so no escaping is needed and there is no limit from the parse
+ * buffer. The write is abandoned if the host sends nothing for read_tmo_ms.
+ */
+uint32_t wrbRemain = 0;         // Bytes still to come
+bool wrbErr = false;            // Write failed - discard the rest
+unsigned long wrbLast = 0;      // millis() when the last byte arrived
+
+void wrb_h(char *params) {
+  char *end;
+  uint32_t len;
+
+  if (params == NULL) {
+    errBadCmd();
+    return;
+  }
+  len = strtoul(params, &end, 10);
+  while ((*end == ' ') || (*end == '\t')) end++;
+  if ((end == params) || *end || !len) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Invalid length"));
+    return;
+  }
+
+  if (gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN)) {
+    if (isVerbose) dataPort.println(F("Failed to address device"));
+    return;
+  }
+  gpibBus.setControls(CTAS);
+  wrbRemain = len;
+  wrbErr = false;
+  wrbLast = millis();
+}
+
+void writeBinary() {
+  int n = dataPort.available();
+
+  if (n <= 0) {
+    if ((unsigned long)(millis() - wrbLast) < (unsigned long)gpibBus.cfg.rtmo) return;
+    if (isVerbose) dataPort.println(F("Binary write timed out"));
+    wrbErr = true;
+    wrbRemain = 0;
+  }
+
+  while ((n-- > 0) && wrbRemain) {
+    uint8_t db = dataPort.read();
+    if (!wrbErr) {
+      // EOI on the last byte whatever ++eoi is set to
+      wrbErr = gpibBus.writeByte(db, (wrbRemain == 1), (wrbRemain == 1));
+      if (!wrbErr) gpibBus.stats.txBytes++;
+    }
+    wrbRemain--;
+  }
+  wrbLast = millis();
+
+  if (!wrbRemain) {
+    gpibBus.unAddressDevice();
+    gpibBus.setControls(CIDS);
+    if (isVerbose) {
+      if (wrbErr) dataPort.println(F("Binary write failed"));
+      showPrompt();
+    }
+  }
 }
 
 uint8_t parseInput(char c) {
@@ -130,7 +244,9 @@ uint8_t parseInput(char c) {
           addPbuf(c);
           isEsc = false;
         } else { // Carriage return on blank line?
-          if (pbPtr == 0) {
+          if (pbPtr == 0 && isLinePart) { // End of a line already sent in parts
+            r = 2;
+          } else if (pbPtr == 0) {
             flushPbuf();
             if (isVerbose) {
               dataPort.println();
@@ -138,14 +254,14 @@ uint8_t parseInput(char c) {
             }
             return 0;
           } else { // check ++ and contains at least 3 characters - command?
-            if (pbPtr>2 && isCmd(pBuf) && !isPlusEscaped) {
+            if (pbPtr>2 && isCmd(pBuf) && !isPlusEscaped && !isLinePart) {
               if (pBuf[2]==0x21) { // Exclamation mark (break read loop command)
                 r = 3;
                 flushPbuf();
               }else{
                 r = 1;
               }
-            }else if (pbPtr>3 && gpibBus.cfg.idn>0 && isIdnQuery(pBuf)){
+            }else if (pbPtr>3 && gpibBus.cfg.idn>0 && isIdnQuery(pBuf) && !isLinePart){
               sendIdn = true;
               flushPbuf();
             }else if (pbPtr > 0) {
@@ -180,7 +296,8 @@ uint8_t parseInput(char c) {
   }
 
   if (pbPtr >= PBSIZE) {
-    if (isCmd(pBuf) && !r && !isPlusEscaped) {  // Command without terminator and buffer full
+    gpibBus.stats.overflows++;
+    if (isCmd(pBuf) && !r && !isPlusEscaped && !isLinePart) {  // Command without terminator and buffer full
       if (isVerbose) {
         dataPort.println(F("ERROR - Command buffer overflow!"));
       }
@@ -189,6 +306,10 @@ uint8_t parseInput(char c) {
       dataBufferFull = true;
       r = 2;
     }
+  } else if (!r && pbPtr >= PBSTREAM && gpibBus.isController() && (isLinePart || !(isCmd(pBuf) && !isPlusEscaped))) {
+    // Long data line - pass this part on to the instrument while the rest arrives
+    dataBufferFull = true;
+    r = 2;
   }
 
   return r;
@@ -200,39 +321,42 @@ uint8_t serialIn_h() {
   // Parse while characters available and line is not complete
   while (dataPort.available() && bufferStatus==0) bufferStatus = parseInput(dataPort.read());
 
+  // Hold off the host until the line (or part) has been processed
+  if (bufferStatus) DATAPORT_READY(false);
+  else DATAPORT_FLOW();
+
   return bufferStatus;
 }
 
 void getCmd(char *buffr) {
   char *token;
   char *params;
-  int i = 0;
+  struct cmdRec cmd;
 
   if (buffr[0] == 0x00 || buffr[0] == CR || buffr[0] == LF) return;
 
   token = strtok(buffr, " \t");
+  if (token == NULL) return;
 
-  for (i=0; cmdHidx[i].token; i++) if (strcasecmp(cmdHidx[i].token, token) == 0) break;
-  
-  if (cmdHidx[i].token) {
-    if (cmdHidx[i].opmode & gpibBus.cfg.cmode) {
-      params = token + strlen(token) + 1;
-  
-      if (strlen(params) > 0) {
-        cmdHidx[i].handler(params);
-      } else {
-        cmdHidx[i].handler(NULL);
-      }
-    } else {
-      errBadCmd();
-      if (isVerbose) dataPort.println(F("getCmd: command not available in this mode."));
-    }
+  if (getCmdRec(token, &cmd) >= 0) {
+    params = token + strlen(token) + 1;
+    runCmd(&cmd, (strlen(params) > 0) ? params : NULL);
   } else {
     errBadCmd();
   }
 }
 
-void execCmd(char *buffr, uint8_t dsize) {
+/***** Call a command handler if the command is available in this mode *****/
+void runCmd(struct cmdRec *cmd, char *params) {
+  if (cmd->opmode & gpibBus.cfg.cmode) {
+    cmd->handler(params);
+  } else {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("getCmd: command not available in this mode."));
+  }
+}
+
+void execCmd(char *buffr, uint16_t dsize) {
   if (isVerbose) dataPort.println(); // Shift output to next line
 
   getCmd(buffr+2);
@@ -254,9 +378,9 @@ void setup() {
   // Initialise parse buffer
   flushPbuf();
 
-  AR_SERIAL_PORT.begin(AR_SERIAL_SPEED);
+  DATAPORT_START();
 
-  if (!isEepromClear()) {
+  if (!isEepromClear(GPIB_CFG_SIZE)) {
     if (!epReadData(gpibBus.cfg.db, GPIB_CFG_SIZE)) {
       epErase();
       gpibBus.setDefaultCfg();
@@ -267,6 +391,11 @@ void setup() {
   // Start the interface in the configured mode
   gpibBus.begin();
 
+#ifdef MACRO_STORE
+  // Compile the macros if they have changed
+  mcInit();
+#endif
+
 #if defined(USE_MACROS) && defined(RUN_STARTUP)
   execMacro(0);
 #endif
@@ -298,33 +427,69 @@ void loop() {
 
   if (gpibBus.isController()) {
     if (lnRdy == 2) { // lnRdy=2: received data - send it to the instrument...
-      sendToInstrument(pBuf, pbPtr);
-      if (gpibBus.cfg.amode == 1 || (gpibBus.cfg.amode == 2 && isQuery)) {
-        errFlg = gpibBus.receiveData(dataPort, gpibBus.cfg.eoi, false, 0);
+      if (sendToInstrument(pBuf, pbPtr) && (gpibBus.cfg.amode == 1 || (gpibBus.cfg.amode == 2 && isQuery))) {
+        errFlg = gpibBus.receiveData(dataPort, gpibBus.cfg.eoi);
         isQuery = false;
       }
     }
 
-    if (isSrqa) { // Automatic serial poll (check status of SRQ and SPOLL if asserted)?
-      if (gpibBus.isAsserted(SRQ)) spoll_h(NULL);
-    }
+    // A line sent in parts, or a binary write, keeps its listener addressed
+    // until the rest of the data arrives, so nothing else may use the bus in
+    // the meantime
+    if (!isLinePart && !wrbRemain) {
+      if (isSrqa == 1) { // Automatic serial poll (check status of SRQ and SPOLL if asserted)?
+        if (gpibBus.isAsserted(SRQ)) spoll_h(NULL);
+      } else if (isSrqa == 3) { // Parallel poll to find the devices to serial poll
+        if (gpibBus.isAsserted(SRQ)) srqPpoll();
+      } else if (isSrqa == 2) { // Report SRQ events latched by the interrupt
+        unsigned long tstamp;
+        if (gpibBus.getSrqEvent(&tstamp)) srqNotify(tstamp);
+        // SRQ held with no new edge: check again now and then, not on every pass
+        else if (gpibBus.isAsserted(SRQ) && ((millis() - srqLast) >= SRQ_RECHECK_MS)) srqNotify(micros());
+      }
+
+      if (schedRun && !lnRdy) runSchedule();
 
-    if ((gpibBus.cfg.amode==3) && autoRead && !lnRdy) errFlg = gpibBus.receiveData(dataPort, readWithEoi, readWithEndByte, endByte);
+#ifdef AR488_USBTMC
+      // Messages from the USBTMC interface
+      Usbtmc.service(gpibBus);
+#endif
+
+      if ((gpibBus.cfg.amode==3) && autoRead && !lnRdy) {
+        if (readBlock) errFlg = gpibBus.receiveBlock(dataPort);
+        else errFlg = gpibBus.receiveData(dataPort, readWithEoi, &rdTerm);
+      }
+    }
 
     if (errFlg && isVerbose) {
       dataPort.println(F("Error while receiving data."));
       errFlg = false;
     }
+  } else if (isRO) {
+    // Listen-only - all traffic including commands is read by lonMode()
+    gpibBus.disableAtnInterrupt();
+#ifdef USE_CAPTURE
+    if (isRO == 2) captureMode();
+    else lonMode();
+#else
+    lonMode();
+#endif
+  } else {
+    // Device mode - act on commands received under ATN
+    uint8_t saddr;
+    uint8_t dstate = gpibBus.getAtnEvent(&saddr);
+    if (dstate) attnRequired(dstate, saddr);
   }
 
   if (sendIdn) { // IDN query
     if (gpibBus.cfg.idn==1) dataPort.println(gpibBus.cfg.sname);
-    if (gpibBus.cfg.idn==2) {dataPort.print(gpibBus.cfg.sname);dataPort.print("-");dataPort.println(gpibBus.cfg.serial);}
+    if (gpibBus.cfg.idn==2) {dataPort.print(gpibBus.cfg.sname);dataPort.print('-');dataPort.println(gpibBus.cfg.serial);}
     sendIdn = false;
   }
 
   // If charaters waiting in the serial input buffer then call handler
-  if (dataPort.available()) lnRdy = serialIn_h();
+  if (wrbRemain) writeBinary();
+  else if (dataPort.available()) lnRdy = serialIn_h();
 
   delayMicroseconds(5);
 }
@@ -341,12 +506,12 @@ bool isCmd(char *buffr) {
 }
 
 bool isIdnQuery(char *buffr) {
-  if (strncasecmp(buffr, "*idn?", 5)==0) return true;
+  if (strncasecmp_P(buffr, PSTR("*idn?"), 5)==0) return true;
   return false;
 }
 
 bool isRead(char *buffr) {
-  if (strncmp(buffr+2, "read", 4) == 0) return true;
+  if (strncmp_P(buffr+2, PSTR("read"), 4) == 0) return true;
   return false;
 }
 
@@ -371,10 +536,37 @@ bool notInRange(char *param, uint16_t lowl, uint16_t higl, uint16_t &rval) {
   return false;
 }
 
-#ifdef USE_MACROS
+#ifdef MACRO_STORE
+/***** Run a compiled macro *****/
+void execMacro(uint8_t idx) {
+  struct mcRec rec;
+  struct cmdRec cmd;
+  uint16_t addr = mcFind(idx);
+
+  flushPbuf();
+  while ((addr = mcRead(addr, rec, pBuf))) {
+    switch (rec.op) {
+      case MC_CMD:
+        if (rec.cidx < cmdHidxSize) {
+          memcpy_P(&cmd, &cmdHidx[rec.cidx], sizeof(struct cmdRec));
+          runCmd(&cmd, rec.len ? pBuf : NULL);
+        } else {
+          errBadCmd();
+        }
+        break;
+      case MC_DATA:
+        sendToInstrument(pBuf, rec.len);
+        break;
+      default:
+        errBadCmd();
+    }
+    flushPbuf();
+  }
+}
+#elif defined(USE_MACROS)
 void execMacro(uint8_t idx) {
   char c;
-  const char * macro = pgm_read_word(macros + idx);
+  const char * macro = mcText(idx);
   int ssize = strlen_P(macro);
 
   // Read characters from macro character array
@@ -466,7 +658,7 @@ void eoi_h(char *params) {
     gpibBus.cfg.eoi = val ? true : false;
     if (isVerbose) {
       dataPort.print(F("Set EOI assertion: "));
-      dataPort.println(val ? "ON" : "OFF");
+      dataPort.println(val ? F("ON") : F("OFF"));
     };
   } else {
     dataPort.println(gpibBus.cfg.eoi);
@@ -487,7 +679,7 @@ void cmode_h(char *params) {
     }
     if (isVerbose) {
       dataPort.print(F("Interface mode set to: "));
-      dataPort.println(val ? "CONTROLLER" : "DEVICE");
+      dataPort.println(val ? F("CONTROLLER") : F("DEVICE"));
     }
   } else {
     dataPort.println(gpibBus.isController());
@@ -501,7 +693,7 @@ void eot_en_h(char *params) {
     gpibBus.cfg.eot_en = val ? true : false;
     if (isVerbose) {
       dataPort.print(F("Appending of EOT character: "));
-      dataPort.println(val ? "ON" : "OFF");
+      dataPort.println(val ? F("ON") : F("OFF"));
     }
   } else {
     dataPort.println(gpibBus.cfg.eot_en);
@@ -522,6 +714,48 @@ void eot_char_h(char *params) {
   }
 }
 
+void fasths_h(char *params) {
+  uint16_t val;
+  if (params != NULL) {
+    if (notInRange(params, 0, 1, val)) return;
+    gpibBus.fastHs = val ? true : false;
+    if (isVerbose) {
+      dataPort.print(F("Fast handshake: "));
+      dataPort.println(val ? F("ON") : F("OFF"));
+    }
+  } else {
+    dataPort.println(gpibBus.fastHs);
+  }
+}
+
+void hs488_h(char *params) {
+  uint16_t val;
+  if (params != NULL) {
+    if (notInRange(params, 0, 1, val)) return;
+    gpibBus.hs488 = val ? true : false;
+    if (isVerbose) {
+      dataPort.print(F("HS488 handshake: "));
+      dataPort.println(val ? F("ON") : F("OFF"));
+    }
+  } else {
+    dataPort.println(gpibBus.hs488);
+  }
+}
+
+void sticky_h(char *params) {
+  uint16_t val;
+  if (params != NULL) {
+    if (notInRange(params, 0, 1, val)) return;
+    gpibBus.setStickyAddressing(val ? true : false);
+    if (isVerbose) {
+      dataPort.print(F("Sticky addressing: "));
+      dataPort.println(val ? F("ON") : F("OFF"));
+    }
+  } else {
+    dataPort.println(gpibBus.stickyAddr);
+  }
+}
+
 void amode_h(char *params) {
   uint16_t val;
   if (params != NULL) {
@@ -543,7 +777,7 @@ void amode_h(char *params) {
 
 void ver_h(char *params) {
   // If "real" requested
-  if (params != NULL && strncasecmp(params, "real", 3) == 0) {
+  if (params != NULL && strncasecmp_P(params, PSTR("real"), 3) == 0) {
     dataPort.println(F(FWVER));
     // Otherwise depends on whether we have a custom string set
   } else {
@@ -556,20 +790,39 @@ void ver_h(char *params) {
 }
 
 void read_h(char *params) {
+  char *param;
+  uint16_t val;
+
   // Clear read flags
   readWithEoi = false;
-  readWithEndByte = false;
-  endByte = 0;
+  readBlock = false;
+  rdTerm.len = 0;
+  rdTerm.count = 0;
   // Read any parameters
-  if (params != NULL) {
-    if (strlen(params) > 3) {
-      if (isVerbose) dataPort.println(F("Invalid parameter - ignored!"));
-    } else if (strncasecmp(params, "eoi", 3) == 0) { // Read with eoi detection
+  param = (params != NULL) ? strtok(params, " \t") : NULL;
+  while (param != NULL) {
+    if (strncasecmp_P(param, PSTR("eoi"), 3) == 0) { // Read with eoi detection
       readWithEoi = true;
-    } else { // Assume ASCII character given and convert to an 8 bit byte
-      readWithEndByte = true;
-      endByte = atoi(params);
+    } else if (strncasecmp_P(param, PSTR("blk"), 3) == 0) { // Read a #<n><len> binary block
+      readBlock = true;
+    } else if (strncasecmp_P(param, PSTR("count"), 5) == 0) { // Read (at most) this number of bytes
+      param = strtok(NULL, " \t");
+      if (param == NULL) {
+        errBadCmd();
+        return;
+      }
+      if (notInRange(param, 1, 65535, val)) return;
+      rdTerm.count = val;
+    } else { // Decimal values of the terminator sequence bytes
+      if (rdTerm.len == TERM_MAX) {
+        errBadCmd();
+        if (isVerbose) dataPort.println(F("Terminator sequence too long"));
+        return;
+      }
+      if (notInRange(param, 0, 255, val)) return;
+      rdTerm.seq[rdTerm.len++] = (uint8_t)val;
     }
+    param = strtok(NULL, " \t");
   }
 
   if (gpibBus.cfg.amode == 3) {
@@ -578,7 +831,8 @@ void read_h(char *params) {
   } else {
     // If auto mode is disabled we do a single read
     gpibBus.addressDevice(gpibBus.cfg.paddr, TALK);
-    gpibBus.receiveData(dataPort, readWithEoi, readWithEndByte, endByte);
+    if (readBlock) gpibBus.receiveBlock(dataPort);
+    else gpibBus.receiveData(dataPort, readWithEoi, &rdTerm);
   }
 }
 
@@ -594,7 +848,7 @@ void clr_h() {
 void llo_h(char *params) {
   if (digitalRead(REN)==LOW) {
     if (params != NULL) {
-      if (0 == strncmp(params, "all", 3)) {
+      if (0 == strncmp_P(params, PSTR("all"), 3)) {
         if (gpibBus.sendCmd(GC_LLO)) {
           if (isVerbose) dataPort.println(F("Failed to send universal LLO."));
         }
@@ -613,7 +867,7 @@ void llo_h(char *params) {
 void loc_h(char *params) {
   if (digitalRead(REN)==LOW) {
     if (params != NULL) {
-      if (strncmp(params, "all", 3) == 0) {
+      if (strncmp_P(params, PSTR("all"), 3) == 0) {
         // Send request to clear all devices to local
         gpibBus.sendAllClear();
       }
@@ -639,16 +893,18 @@ void ifc_h() {
   }
 }
 
-void trg_h(char *params) {
+/***** Read a list of up to 15 addresses into addrs *****/
+/*
+ * With no parameters the currently addressed device is used.
+ * Returns the number of addresses, or 0 if a parameter is out of range.
+ */
+uint8_t getAddrList(char *params, uint8_t *addrs) {
   char *param;
-  uint8_t addrs[15] = {0};
   uint16_t val = 0;
   uint8_t cnt = 0;
 
-  addrs[0] = addrs[0]; // Meaningless as both are zero but defaults compiler warning!
-
   if (params == NULL) {
-    // No parameters - trigger addressed device only
+    // No parameters - use addressed device only
     addrs[0] = gpibBus.cfg.paddr;
     cnt++;
   } else {
@@ -662,12 +918,18 @@ void trg_h(char *params) {
       if (param == NULL) {
         break;  // Stop when there are no more parameters
       }else{    
-        if (notInRange(param, 1, 30, val)) return;
+        if (notInRange(param, 1, 30, val)) return 0;
         addrs[cnt] = (uint8_t)val;
         cnt++;
       }
     }
   }
+  return cnt;
+}
+
+void trg_h(char *params) {
+  uint8_t addrs[15] = {0};
+  uint8_t cnt = getAddrList(params, addrs);
 
   // If we have some addresses to trigger....
   if (cnt > 0) {
@@ -686,6 +948,35 @@ void trg_h(char *params) {
   }
 }
 
+/***** Trigger a group of devices and read back each result *****/
+/*
+ * All devices are addressed to listen and triggered with a single GET, then
+ * each device is read in turn and its response returned as addr:value.
+ */
+void trgread_h(char *params) {
+  uint8_t addrs[15] = {0};
+  uint8_t cnt = getAddrList(params, addrs);
+  uint8_t paddr = gpibBus.cfg.paddr;
+
+  if (cnt == 0) return;
+
+  if (gpibBus.sendGroupGET(addrs, cnt)) {
+    gpibBus.setControls(CIDS);
+    if (isVerbose) dataPort.println(F("Failed to trigger devices!"));
+    return;
+  }
+  gpibBus.setControls(CIDS);
+
+  for (uint8_t i = 0; i < cnt; i++) {
+    dataPort.print(addrs[i]);
+    dataPort.print(':');
+    gpibBus.cfg.paddr = addrs[i];
+    // Terminate the line ourselves if the read failed
+    if (gpibBus.receiveData(dataPort, false)) dataPort.println();
+  }
+  gpibBus.cfg.paddr = paddr;
+}
+
 void rst_h() {
 #ifdef WDTO_1S
   // Where defined, reset controller using watchdog timeout
@@ -712,7 +1003,6 @@ void spoll_h(char *params) {
   uint8_t j = 0;
   uint16_t addrval = 0;
   bool all = false;
-  bool eoiDetected = false;
 
   // Initialise address array
   for (int i = 0; i < 15; i++) {
@@ -736,7 +1026,7 @@ void spoll_h(char *params) {
       if (!param) break;
       
       // The 'all' parameter given?
-      if (strncmp(param, "all", 3) == 0) {
+      if (strncmp_P(param, PSTR("all"), 3) == 0) {
         all = true;
         j = 30;
         if (isVerbose) dataPort.println(F("Serial poll of all devices requested..."));
@@ -756,14 +1046,8 @@ void spoll_h(char *params) {
     }
   }
 
-  // Send Unlisten [UNL] to all devices
-  if ( gpibBus.sendCmd(GC_UNL) ) return;
-
-  // Controller addresses itself as listner
-  if ( gpibBus.sendCmd(GC_LAD + gpibBus.cfg.caddr) ) return;
-
-  // Send Serial Poll Enable [SPE] to all devices
-  if ( gpibBus.sendCmd(GC_SPE) ) return;
+  // Send UNL, address controller to listen and send SPE
+  if ( gpibBus.startSerialPoll() ) return;
 
   // Poll GPIB address or addresses as set by i and j
   for (int i = 0; i < j; i++) {
@@ -772,12 +1056,9 @@ void spoll_h(char *params) {
 
     // Don't need to poll own address
     if (addrval != gpibBus.cfg.caddr) {
-      if ( gpibBus.sendCmd(GC_TAD + addrval) ) return;
-      // Set GPIB control to controller active listner state (ATN unasserted)
-      gpibBus.setControls(CLAS);
-
-      // Read the response byte (usually device status) using handshake - suppress EOI detection
-      r = gpibBus.readByte(&sb, false, &eoiDetected);
+      // Address device to talk and read the status byte
+      r = gpibBus.serialPoll(addrval, &sb);
+      if (r == 0xFF) return;
 
       // If we successfully read a byte
       if (!r) {
@@ -807,19 +1088,302 @@ void spoll_h(char *params) {
   }
   if (all) dataPort.println();
 
-  // Send Serial Poll Disable [SPD] to all devices
-  if ( gpibBus.sendCmd(GC_SPD) ) return;
+  // Send SPD, UNT and UNL and return to controller idle state
+  if ( gpibBus.endSerialPoll() ) return;
 
-  // Send Untalk [UNT] to all devices
-  if ( gpibBus.sendCmd(GC_UNT) ) return;
+  if (isVerbose) dataPort.println(F("Serial poll completed."));
+}
 
-  // Unadress listners [UNL] to all devices
-  if ( gpibBus.sendCmd(GC_UNL) ) return;
+/***** Batch serial poll *****/
+/*
+ * Polls a list of addresses, or the addresses that responded to an earlier poll,
+ * inside a single SPE/SPD sequence and returns all status bytes on one line as
+ * addr:status,addr:status,... Addresses that fail to respond are dropped from the
+ * list of present devices so that later polls skip them. With no list of present
+ * devices, or with the 'scan' parameter, all addresses are polled.
+ */
+uint32_t spollPresent = 0;   // Bit n set when a device at address n responded
+
+void bspoll_h(char *params) {
+  char *param;
+  uint32_t pollset = 0;
+  uint16_t addrval = 0;
+  uint8_t sb = 0;
+  uint8_t r;
+  bool first = true;
 
-  // Set GPIB control to controller idle state
-  gpibBus.setControls(CIDS);
+  if (params != NULL) {
+    param = strtok(params, " \t");
+    while (param) {
+      if (strncmp_P(param, PSTR("scan"), 4) == 0) {
+        pollset = 0x7FFFFFFE;
+      } else {
+        if (notInRange(param, 1, 30, addrval)) return;
+        pollset |= (1UL << addrval);
+      }
+      param = strtok(NULL, " \t");
+    }
+  } else {
+    pollset = spollPresent ? spollPresent : 0x7FFFFFFE;
+  }
+  // Don't need to poll own address
+  pollset &= ~(1UL << gpibBus.cfg.caddr);
+
+  // Send UNL, address controller to listen and send SPE
+  if ( gpibBus.startSerialPoll() ) return;
+
+  for (uint8_t addr = 1; addr < 31; addr++) {
+    if (!(pollset & (1UL << addr))) continue;
+    r = gpibBus.serialPoll(addr, &sb);
+    if (r == 0xFF) return;
+    if (r == 0) {
+      spollPresent |= (1UL << addr);
+      if (!first) dataPort.print(',');
+      dataPort.print(addr); dataPort.print(':'); dataPort.print(sb, DEC);
+      first = false;
+    } else {
+      spollPresent &= ~(1UL << addr);
+    }
+  }
+  dataPort.println();
 
-  if (isVerbose) dataPort.println(F("Serial poll completed."));
+  // Send SPD, UNT and UNL and return to controller idle state
+  if ( gpibBus.endSerialPoll() ) return;
+
+  if (isVerbose) dataPort.println(F("Batch serial poll completed."));
+}
+
+/***** Serial poll a set of addresses and report those requesting service *****/
+/*
+ * Must be called between startSerialPoll() and endSerialPoll(). Each device
+ * with RQS set is reported as SRQ:addr,status and, when stamp is set, with
+ * ,tstamp appended. Addresses that respond are added to spollPresent and those
+ * that do not are dropped. Stops once SRQ has been released. Returns the number
+ * of devices reported or 0xFF if the bus could not be addressed.
+ */
+uint8_t srqPollSet(uint32_t pollset, bool stamp, unsigned long tstamp) {
+  uint8_t sb;
+  uint8_t r;
+  uint8_t cnt = 0;
+
+  pollset &= ~(1UL << gpibBus.cfg.caddr);
+  for (uint8_t addr = 1; addr < 31; addr++) {
+    if (!(pollset & (1UL << addr))) continue;
+    sb = 0;
+    r = gpibBus.serialPoll(addr, &sb);
+    if (r == 0xFF) return 0xFF;
+    if (r) {
+      // No response (timeout)
+      spollPresent &= ~(1UL << addr);
+      continue;
+    }
+    spollPresent |= (1UL << addr);
+    if (sb & 0x40) {
+      dataPort.print(F("SRQ:")); dataPort.print(addr); dataPort.print(',');
+      dataPort.print(sb, DEC);
+      if (stamp) {
+        dataPort.print(','); dataPort.print(tstamp);
+      }
+      dataPort.println();
+      cnt++;
+    }
+    // Stop once all requests have been cleared
+    if (!gpibBus.isAsserted(SRQ)) break;
+  }
+  return cnt;
+}
+
+/***** Report every device requesting service *****/
+/*
+ * Used by ++srqauto 2. Each device with RQS set is reported as
+ * SRQ:addr,status,timestamp where the timestamp is micros() when SRQ was asserted.
+ * The devices known to be present (see ++bspoll) are polled first, so absent
+ * addresses do not each cost a read timeout. If SRQ is still asserted the
+ * remaining addresses are then scanned and any device that answers is added
+ * to the known set.
+ */
+void srqNotify(unsigned long tstamp) {
+  uint32_t known = spollPresent;
+  uint8_t r = 0;
+
+  if ( gpibBus.startSerialPoll() ) return;
+  if (known) r = srqPollSet(known, true, tstamp);
+  // A device outside the known set may be requesting service
+  if ((r != 0xFF) && gpibBus.isAsserted(SRQ)) srqPollSet(0x7FFFFFFE & ~known, true, tstamp);
+  gpibBus.endSerialPoll();
+  srqLast = millis();
+}
+
+/***** Show or reset the transfer statistics *****/
+void printStat(const __FlashStringHelper *name, uint32_t val) {
+  dataPort.print(name);
+  dataPort.println(val);
+}
+
+void printStatArray(const __FlashStringHelper *name, uint16_t vals[5]) {
+  dataPort.print(name);
+  for (uint8_t i = 0; i < 5; i++) {
+    if (i) dataPort.print(',');
+    dataPort.print(vals[i]);
+  }
+  dataPort.println();
+}
+
+void stats_h(char *params) {
+  struct GPIBbus::GPIBstats &st = gpibBus.stats;
+
+  if (params != NULL) {
+    if (strncasecmp_P(params, PSTR("reset"), 5) == 0) {
+      gpibBus.clearStats();
+#ifdef AR_SERIAL_CTS_PIN
+      dataPortDropped = 0;
+#endif
+      if (isVerbose) dataPort.println(F("Statistics cleared."));
+    } else {
+      errBadCmd();
+      if (isVerbose) dataPort.println(F("Invalid parameter"));
+    }
+    return;
+  }
+
+  printStat(F("rx_bytes: "), st.rxBytes);
+  printStat(F("rx_count: "), st.rxCount);
+  printStat(F("rx_us: "), st.rxMicros);
+  printStat(F("rx_Bps: "), st.rxMicros ? (uint32_t)((float)st.rxBytes * 1000000.0 / st.rxMicros) : 0);
+  printStat(F("tx_bytes: "), st.txBytes);
+  printStat(F("tx_count: "), st.txCount);
+  printStat(F("tx_us: "), st.txMicros);
+  printStat(F("tx_Bps: "), st.txMicros ? (uint32_t)((float)st.txBytes * 1000000.0 / st.txMicros) : 0);
+  printStatArray(F("rd_tmo(4-8): "), st.rdTmo);
+  printStatArray(F("wr_tmo(4-8): "), st.wrTmo);
+  printStat(F("ifc_abort: "), st.ifcAborts);
+  printStat(F("atn_abort: "), st.atnAborts);
+  printStat(F("overflow: "), st.overflows);
+#ifdef AR_SERIAL_CTS_PIN
+  printStat(F("cts_drop: "), dataPortDropped);
+#endif
+}
+
+/***** Measure sustained throughput of the GPIB and serial paths *****/
+/*
+ * write  - writeByte() handshakes to the addressed instrument (spaces, then LF)
+ * read   - readByte() from the addressed instrument (data is discarded)
+ * serial - raw output to the serial port in blocks
+ */
+void printBench(const __FlashStringHelper *name, uint16_t cnt, unsigned long us) {
+  dataPort.print(name);
+  dataPort.print(cnt);
+  dataPort.print(F(" bytes, "));
+  dataPort.print(us);
+  dataPort.print(F(" us, "));
+  dataPort.print(us ? (uint32_t)((float)cnt * 1000000.0 / us) : 0);
+  dataPort.print(F(" B/s, "));
+  dataPort.print(cnt ? ((float)us / cnt) : 0.0, 2);
+  dataPort.println(F(" us/byte"));
+}
+
+#ifdef AR488_SIMBUS
+/***** Line function calls per byte of the last ++bench run *****/
+void printSimCalls(uint16_t cnt) {
+  if (!cnt) return;
+  dataPort.print(F("calls/byte: hs="));
+  dataPort.print((float)simStat.hsReads / cnt, 2);
+  dataPort.print(F(" ctrl="));
+  dataPort.print((float)simStat.ctrlSets / cnt, 2);
+  dataPort.print(F(" dbus="));
+  dataPort.println((float)(simStat.dbusReads + simStat.dbusWrites) / cnt, 2);
+}
+#endif
+
+void bench_h(char *params) {
+  char *param;
+  uint16_t cnt = 1000;
+  uint16_t done = 0;
+  uint8_t db = 0;
+  bool eoiDetected = false;
+  unsigned long tstart;
+  unsigned long tend;
+
+  param = (params != NULL) ? strtok(params, " \t") : NULL;
+  if (param == NULL) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Specify write, read or serial"));
+    return;
+  }
+  char *cntstr = strtok(NULL, " \t");
+  if (cntstr != NULL) {
+    if (notInRange(cntstr, 1, 65000, cnt)) return;
+  }
+
+  // The GPIB tests address the instrument, which requires controller mode
+  if (!gpibBus.isController() && (strncasecmp_P(param, PSTR("serial"), 6) != 0)) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Only serial is available in device mode"));
+    return;
+  }
+
+  if (strncasecmp_P(param, PSTR("write"), 5) == 0) {
+    if (gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN)) {
+      if (isVerbose) dataPort.println(F("Failed to address device"));
+      return;
+    }
+    gpibBus.setControls(CTAS);
+#ifdef AR488_SIMBUS
+    simClearStats();
+#endif
+    tstart = micros();
+    for (done = 0; done < cnt; done++) {
+      if (gpibBus.writeByte((done == cnt - 1) ? LF : ' ', (done == cnt - 1))) break;
+    }
+    tend = micros();
+    gpibBus.unAddressDevice();
+    gpibBus.setControls(CIDS);
+    printBench(F("write: "), done, tend - tstart);
+#ifdef AR488_SIMBUS
+    printSimCalls(done);
+#endif
+
+  } else if (strncasecmp_P(param, PSTR("read"), 4) == 0) {
+    if (gpibBus.addressDevice(gpibBus.cfg.paddr, TALK)) {
+      if (isVerbose) dataPort.println(F("Failed to address device"));
+      return;
+    }
+    gpibBus.setControls(CLAS);
+#ifdef AR488_SIMBUS
+    simClearStats();
+#endif
+    tstart = micros();
+    for (done = 0; done < cnt; ) {
+      if (gpibBus.readByte(&db, true, &eoiDetected)) break;
+      done++;
+      if (eoiDetected) break;
+    }
+    tend = micros();
+    gpibBus.unAddressDevice();
+    gpibBus.setControls(CIDS);
+    printBench(F("read: "), done, tend - tstart);
+#ifdef AR488_SIMBUS
+    printSimCalls(done);
+#endif
+
+  } else if (strncasecmp_P(param, PSTR("serial"), 6) == 0) {
+    uint8_t blk[64];
+    uint16_t n;
+    memset(blk, '.', sizeof(blk));
+    tstart = micros();
+    for (done = 0; done < cnt; done += n) {
+      n = ((uint16_t)(cnt - done) < (uint16_t)sizeof(blk)) ? (cnt - done) : (uint16_t)sizeof(blk);
+      dataPort.write(blk, n);
+    }
+    dataPort.flush();
+    tend = micros();
+    dataPort.println();
+    printBench(F("serial: "), done, tend - tstart);
+
+  } else {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Specify write, read or serial"));
+  }
 }
 
 void srq_h() {
@@ -849,15 +1413,31 @@ void save_h() {
 void lon_h(char *params) {
   uint16_t lval;
   if (params != NULL) {
+#ifdef USE_CAPTURE
+    if (notInRange(params, 0, 2, lval)) return;
+#else
     if (notInRange(params, 0, 1, lval)) return;
-    isRO = lval ? true : false;
+#endif
+    isRO = (uint8_t)lval;
     if (isRO) {
       isTO = 0;       // Talk-only mode must be disabled!
       isProm = false; // Promiscuous mode must be disabled!
+    } else if (!gpibBus.isController()) {
+      // Resume responding to ATN as a device
+      gpibBus.enableAtnInterrupt();
     }
     if (isVerbose) {
       dataPort.print(F("LON: "));
-      dataPort.println(lval ? "ON" : "OFF") ;
+      switch (isRO) {
+        case 1:
+          dataPort.println(F("ON"));
+          break;
+        case 2:
+          dataPort.println(F("ON capture"));
+          break;
+        default:
+          dataPort.println(F("OFF"));
+      }
     }
   } else {
     dataPort.println(isRO);
@@ -934,18 +1514,7 @@ void eor_h(char *params) {
 }
 
 void ppoll_h() {
-  uint8_t sb = 0;
-
-  gpibBus.setControls(CIDS);
-  delayMicroseconds(20);
-  // Assert ATN and EOI
-  gpibBus.setControlVal(0b00000000, 0b10010000, 0);
-  //  setGpibState(0b10010000, 0b00000000, 0b10010000);
-  delayMicroseconds(20);
-  // Read data byte from GPIB bus without handshake
-  sb = readGpibDbus();
-  // Return to controller idle state (ATN and EOI unasserted)
-  gpibBus.setControls(CIDS);
+  uint8_t sb = gpibBus.parallelPoll();
 
   // Output the response byte
   dataPort.println(sb, DEC);
@@ -953,6 +1522,111 @@ void ppoll_h() {
   if (isVerbose) dataPort.println(F("Parallel poll completed."));
 }
 
+/***** Assign parallel poll response lines *****/
+/*
+ * ++ppconfig                    - show the assigned lines as addr:line,...
+ * ++ppconfig addr line [sense]  - respond on DIO line (1-8) when ist = sense (default 1)
+ * ++ppconfig addr off           - disable the response of the device (PPD)
+ * ++ppconfig clear              - disable the response of all devices (PPU)
+ *
+ * The assignments are used by ++srqauto 3 to find the devices requesting service.
+ */
+uint8_t ppLine[31];   // DIO line (1-8) assigned to each address, 0 = none
+
+void ppconfig_h(char *params) {
+  char *param;
+  uint16_t addr;
+  uint16_t line;
+  uint16_t sense = 1;
+  bool first = true;
+
+  if (params == NULL) {
+    for (uint8_t i = 1; i < 31; i++) {
+      if (!ppLine[i]) continue;
+      if (!first) dataPort.print(',');
+      dataPort.print(i); dataPort.print(':'); dataPort.print(ppLine[i]);
+      first = false;
+    }
+    dataPort.println();
+    return;
+  }
+
+  param = strtok(params, " \t");
+  if (param == NULL) {
+    errBadCmd();
+    return;
+  }
+  if (strncmp_P(param, PSTR("clear"), 5) == 0) {
+    if (gpibBus.unconfigParallelPoll()) {
+      if (isVerbose) dataPort.println(F("Sending PPU failed"));
+      return;
+    }
+    memset(ppLine, 0, sizeof(ppLine));
+    if (isVerbose) dataPort.println(F("Parallel poll responses cleared."));
+    return;
+  }
+
+  if (notInRange(param, 1, 30, addr)) return;
+  param = strtok(NULL, " \t");
+  if (param == NULL) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Missing parameter"));
+    return;
+  }
+  if (strncmp_P(param, PSTR("off"), 3) == 0) {
+    line = 0;
+  } else {
+    if (notInRange(param, 1, 8, line)) return;
+    param = strtok(NULL, " \t");
+    if (param && notInRange(param, 0, 1, sense)) return;
+  }
+
+  if (gpibBus.configParallelPoll(addr, line ? (GC_PPE | (sense << 3) | (line - 1)) : GC_PPD)) {
+    if (isVerbose) dataPort.println(F("Sending PPC failed"));
+    return;
+  }
+  ppLine[addr] = line;
+  if (isVerbose) {
+    dataPort.print(F("Device "));
+    dataPort.print(addr);
+    if (line) {
+      dataPort.print(F(" responds on DIO"));
+      dataPort.println(line);
+    } else {
+      dataPort.println(F(" parallel poll response disabled"));
+    }
+  }
+}
+
+/***** Find the devices requesting service with a parallel poll *****/
+/*
+ * Used by ++srqauto 3. Only the devices whose parallel poll line is asserted
+ * are serial polled. If SRQ is still asserted, the devices with no line
+ * assigned that are known to be present (see ++bspoll) are polled as well, in
+ * case the request came from one of them. All devices with no line assigned
+ * are polled while no devices are known yet. Each device with RQS set is
+ * reported as SRQ:addr,status.
+ */
+void srqPpoll() {
+  uint8_t pp = gpibBus.parallelPoll();
+  uint32_t pollset = 0;
+  uint32_t others = 0;
+  uint8_t r = 0;
+
+  for (uint8_t addr = 1; addr < 31; addr++) {
+    if (!ppLine[addr]) others |= (1UL << addr);
+    else if (pp & (1 << (ppLine[addr] - 1))) pollset |= (1UL << addr);
+  }
+  if (spollPresent) others &= spollPresent;
+
+  if ( gpibBus.startSerialPoll() ) return;
+
+  if (pollset) r = srqPollSet(pollset, false, 0);
+  if ((r != 0xFF) && others && gpibBus.isAsserted(SRQ)) srqPollSet(others, false, 0);
+
+  gpibBus.endSerialPoll();
+}
+
 void ren_h(char *params) {
   uint16_t val;
   if (params != NULL) {
@@ -960,7 +1634,7 @@ void ren_h(char *params) {
     digitalWrite(REN, (val ? LOW : HIGH));
     if (isVerbose) {
       dataPort.print(F("REN: "));
-      dataPort.println(val ? "REN asserted" : "REN un-asserted") ;
+      dataPort.println(val ? F("REN asserted") : F("REN un-asserted")) ;
     };
   } else {
     dataPort.println(digitalRead(REN) ? 0 : 1);
@@ -969,8 +1643,8 @@ void ren_h(char *params) {
 
 void verb_h() {
   isVerbose = !isVerbose;
-  dataPort.print("Verbose: ");
-  dataPort.println(isVerbose ? "ON" : "OFF");
+  dataPort.print(F("Verbose: "));
+  dataPort.println(isVerbose ? F("ON") : F("OFF"));
 }
 
 void setvstr_h(char *params) {
@@ -978,7 +1652,7 @@ void setvstr_h(char *params) {
   char idparams[64];
   plen = strlen(params);
   memset(idparams, '\0', 64);
-  strncpy(idparams, "verstr ", 7);
+  strncpy_P(idparams, PSTR("verstr "), 7);
   if (plen>47) plen = 47; // Ignore anything over 47 characters
   strncat(idparams, params, plen);
 
@@ -992,11 +1666,11 @@ void prom_h(char *params) {
     isProm = pval ? true : false;
     if (isProm) {
       isTO = 0;     // Talk-only mode must be disabled!
-      isRO = false; // Listen-only mode must be disabled!
+      isRO = 0;     // Listen-only mode must be disabled!
     }
     if (isVerbose) {
       dataPort.print(F("PROM: "));
-      dataPort.println(pval ? "ON" : "OFF") ;
+      dataPort.println(pval ? F("ON") : F("OFF")) ;
     }
   } else {
     dataPort.println(isProm);
@@ -1009,7 +1683,7 @@ void ton_h(char *params) {
     if (notInRange(params, 0, 2, toval)) return;
     isTO = (uint8_t)toval;
     if (isTO>0) {
-      isRO = false;   // Read-only mode must be disabled in TO mode!
+      isRO = 0;       // Read-only mode must be disabled in TO mode!
       isProm = false; // Promiscuous mode must be disabled in TO mode!
     }
   }else{
@@ -1033,73 +1707,188 @@ void ton_h(char *params) {
 void srqa_h(char *params) {
   uint16_t val;
   if (params != NULL) {
-    if (notInRange(params, 0, 1, val)) return;
+    if (notInRange(params, 0, 3, val)) return;
+    gpibBus.disableSrqInterrupt();
     switch (val) {
       case 0:
-        isSrqa = false;
+        isSrqa = 0;
         break;
       case 1:
-        isSrqa = true;
+        isSrqa = 1;
         break;
+      case 2:
+        if (!gpibBus.enableSrqInterrupt()) {
+          errBadCmd();
+          if (isVerbose) dataPort.println(F("SRQ pin has no interrupt on this board"));
+          return;
+        }
+        isSrqa = 2;
+        break;
+      case 3:
+        isSrqa = 3;
+        break;
+    }
+    if (isVerbose) {
+      dataPort.print(F("SRQ auto: "));
+      dataPort.println(isSrqa == 3 ? F("PPOLL") : (isSrqa == 2 ? F("NOTIFY") : (isSrqa ? F("ON") : F("OFF"))));
     }
-    if (isVerbose) dataPort.println(isSrqa ? "SRQ auto ON" : "SRQ auto OFF") ;
   } else {
     dataPort.println(isSrqa);
   }
 }
 
+/***** Periodic acquisition *****/
+/*
+ * ++repeat count period cmdstring  - start sending cmdstring every period ms
+ * ++repeat addr [pad1 ... pad15]    - addresses to query (none = current address)
+ * ++repeat stop                     - stop the scheduler
+ * The scheduler runs from loop() so that commands and SRQ are still serviced.
+ */
 void repeat_h(char *params) {
 
-  uint16_t count;
-  uint16_t tmdly;
+  uint16_t count = 0;
+  uint16_t tmdly = 0;
   char *param;
 
-  if (params != NULL) {
-    // Count (number of repetitions)
-    param = strtok(params, " \t");
-    if (strlen(param) > 0) {
-      if (notInRange(param, 2, 255, count)) return;
-    }
-    // Time delay (milliseconds)
-    param = strtok(NULL, " \t");
-    if (strlen(param) > 0) {
-      if (notInRange(param, 0, 30000, tmdly)) return;
-    }
+  if (params == NULL) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Missing parameters"));
+    return;
+  }
+
+  param = strtok(params, " \t");
+
+  if (strncasecmp_P(param, PSTR("stop"), 4) == 0) {
+    schedRun = false;
+    if (isVerbose) dataPort.println(F("Repeat stopped."));
+    return;
+  }
 
+  if (strncasecmp_P(param, PSTR("addr"), 4) == 0) {
     // Pointer to remainder of parameters string
     param = strtok(NULL, "\n\r");
-    if (strlen(param) > 0) {
-      for (uint16_t i = 0; i < count; i++) {
-        // Send string to instrument
-        gpibBus.sendData(param, strlen(param));
-        delay(tmdly);
-        gpibBus.receiveData(dataPort, gpibBus.cfg.eoi, false, 0);
-      }
-    } else {
-      errBadCmd();
-      if (isVerbose) dataPort.println(F("Missing parameter"));
-      return;
-    }
-  } else {
+    schedAddrCnt = (param != NULL) ? getAddrList(param, schedAddrs) : 0;
+    return;
+  }
+
+  // Count (number of repetitions)
+  if (notInRange(param, 0, 65000, count)) return;
+  // Period (milliseconds)
+  param = strtok(NULL, " \t");
+  if (param == NULL || notInRange(param, 0, 30000, tmdly)) {
+    if (param == NULL) errBadCmd();
+    return;
+  }
+
+  // Pointer to remainder of parameters string
+  param = strtok(NULL, "\n\r");
+  if (param == NULL || strlen(param) == 0) {
     errBadCmd();
-    if (isVerbose) dataPort.println(F("Missing parameters"));
+    if (isVerbose) dataPort.println(F("Missing parameter"));
+    return;
+  }
+  if (strlen(param) >= SCHED_QSIZE) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Command string too long"));
+    return;
+  }
+
+  strcpy(schedQuery, param);
+  schedCount = count;
+  schedPeriod = (unsigned long)tmdly * 1000UL;
+  schedNext = micros();
+  schedRun = true;
+}
+
+/***** Run the scheduled query when the period has elapsed *****/
+/*
+ * Each response is returned as addr,timestamp:value where timestamp is the
+ * micros() time at which the query was sent.
+ */
+void runSchedule() {
+  unsigned long now = micros();
+  unsigned long tstamp;
+  uint8_t paddr = gpibBus.cfg.paddr;
+  uint8_t cnt = schedAddrCnt ? schedAddrCnt : 1;
+
+  if ((long)(now - schedNext) < 0) return;
+
+  // Wait while a line sent in parts or a binary write holds the bus, and
+  // while ++auto 3 is reading
+  if (isLinePart || wrbRemain || ((gpibBus.cfg.amode == 3) && autoRead)) return;
+
+  // Keep to a fixed period, skipping any samples that have been missed
+  schedNext += schedPeriod;
+  if ((long)(now - schedNext) >= 0) schedNext = now + schedPeriod;
+
+  for (uint8_t i = 0; i < cnt; i++) {
+    if (schedAddrCnt) gpibBus.cfg.paddr = schedAddrs[i];
+    tstamp = micros();
+    gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN);
+    gpibBus.sendData(schedQuery, strlen(schedQuery));
+    gpibBus.unAddressDevice();
+    dataPort.print(gpibBus.cfg.paddr);
+    dataPort.print(',');
+    dataPort.print(tstamp);
+    dataPort.print(':');
+    // Terminate the line ourselves if the read failed
+    if (gpibBus.receiveData(dataPort, gpibBus.cfg.eoi)) dataPort.println();
   }
+  gpibBus.cfg.paddr = paddr;
+
+  if (schedCount && (--schedCount == 0)) schedRun = false;
 }
 
 void macro_h(char *params) {
 #ifdef USE_MACROS
   uint16_t val;
-  const char * macro;
 
   if (params != NULL) {
+#ifdef MACRO_STORE
+    // Add a line to, or clear, a stored macro
+    char *param = strtok(params, " \t");
+    if ((strcmp_P(param, PSTR("add")) == 0) || (strcmp_P(param, PSTR("clear")) == 0)) {
+      bool add = (param[0] == 'a');
+      param = strtok(NULL, " \t");
+      if (param == NULL) {
+        errBadCmd();
+        return;
+      }
+      if (notInRange(param, 0, 9, val)) return;
+      if (add) {
+        param = strtok(NULL, "");
+        if (param == NULL) {
+          errBadCmd();
+          return;
+        }
+        if (strlen(param) >= MC_LINE_LEN) {
+          errBadCmd();
+          if (isVerbose) dataPort.println(F("Macro line too long"));
+          return;
+        }
+        if (mcAdd((uint8_t)val, param)) {
+          dataPort.println(F("Macro store full"));
+          return;
+        }
+      } else {
+        mcClear((uint8_t)val);
+      }
+      if (isVerbose) dataPort.println(F("Macro updated."));
+      return;
+    }
+    params = param;
+#endif
     if (notInRange(params, 0, 9, val)) return;
     runMacro = (uint8_t)val;
   } else {
     for (int i = 0; i < 10; i++) {
-      macro = (pgm_read_word(macros + i));
-      if (strlen_P(macro) > 0) {
+#ifdef MACRO_STORE
+      if (mcIsDefined(i)) {
+#else
+      if (strlen_P(mcText(i)) > 0) {
+#endif
         dataPort.print(i);
-        dataPort.print(" ");
+        dataPort.print(' ');
       }
     }
     dataPort.println();
@@ -1110,6 +1899,79 @@ void macro_h(char *params) {
 #endif
 }
 
+/***** Print or control the bus trace *****/
+/*
+ * ++trace prints the buffer and clears it. ++trace on|off starts or stops
+ * logging and ++trace clear empties the buffer.
+ */
+void trace_h(char *params) {
+#ifdef TRACE_ENABLE
+  if (params == NULL) {
+    tracePrint(dataPort);
+  } else if (strcmp_P(params, PSTR("on")) == 0) {
+    traceOn = true;
+  } else if (strcmp_P(params, PSTR("off")) == 0) {
+    traceOn = false;
+  } else if (strcmp_P(params, PSTR("clear")) == 0) {
+    traceClear();
+  } else {
+    errBadCmd();
+  }
+#else
+  dataPort.println(F("Disabled"));
+#endif
+}
+
+/***** Show or set up the simulated bus *****/
+/*
+ * simbus            - show the line function call counters and settings
+ * simbus reset      - clear the counters
+ * simbus delay <n>  - line reads before an instrument responds (0-255)
+ * simbus len <n>    - length of an instrument response (1-65000)
+ */
+void simbus_h(char *params) {
+#ifdef AR488_SIMBUS
+  char *param;
+  char *valstr;
+  uint16_t val;
+
+  param = (params != NULL) ? strtok(params, " \t") : NULL;
+  if (param == NULL) {
+    printStat(F("hs_reads: "), simStat.hsReads);
+    printStat(F("ctrl_sets: "), simStat.ctrlSets);
+    printStat(F("dbus_reads: "), simStat.dbusReads);
+    printStat(F("dbus_writes: "), simStat.dbusWrites);
+    printStat(F("bytes: "), simStat.bytes);
+    printStat(F("delay: "), simDelay);
+    printStat(F("len: "), simLen);
+    return;
+  }
+
+  if (strncasecmp_P(param, PSTR("reset"), 5) == 0) {
+    simClearStats();
+    if (isVerbose) dataPort.println(F("Counters cleared."));
+    return;
+  }
+
+  valstr = strtok(NULL, " \t");
+  if (valstr == NULL) {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Missing value"));
+  } else if (strncasecmp_P(param, PSTR("delay"), 5) == 0) {
+    if (notInRange(valstr, 0, 255, val)) return;
+    simDelay = (uint8_t)val;
+  } else if (strncasecmp_P(param, PSTR("len"), 3) == 0) {
+    if (notInRange(valstr, 1, 65000, val)) return;
+    simLen = val;
+  } else {
+    errBadCmd();
+    if (isVerbose) dataPort.println(F("Specify reset, delay or len"));
+  }
+#else
+  dataPort.println(F("Disabled"));
+#endif
+}
+
 void xdiag_h(char *params){
   char *param;
   uint8_t mode = 0;
@@ -1168,7 +2030,7 @@ void id_h(char *params) {
     datastr = keyword + strlen(keyword) + 1;
     dlen = strlen(datastr);
     if (dlen) {
-      if (strncasecmp(keyword, "verstr", 6)==0) {
+      if (strncasecmp_P(keyword, PSTR("verstr"), 6)==0) {
         if (dlen>0 && dlen<48) {
           memset(gpibBus.cfg.vstr, '\0', 48);
           strncpy(gpibBus.cfg.vstr, datastr, dlen);
@@ -1179,7 +2041,7 @@ void id_h(char *params) {
         }
         return;
       }
-      if (strncasecmp(keyword, "name", 4)==0) {
+      if (strncasecmp_P(keyword, PSTR("name"), 4)==0) {
         if (dlen>0 && dlen<16) {
           memset(gpibBus.cfg.sname, '\0', 16);
           strncpy(gpibBus.cfg.sname, datastr, dlen);
@@ -1189,7 +2051,7 @@ void id_h(char *params) {
         }
         return;
       }
-      if (strncasecmp(keyword, "serial", 6)==0) {
+      if (strncasecmp_P(keyword, PSTR("serial"), 6)==0) {
         if (dlen < 10) {
           gpibBus.cfg.serial = atol(datastr);
         }else{
@@ -1199,21 +2061,21 @@ void id_h(char *params) {
         return;
       }
     }else{
-      if (strncasecmp(keyword, "verstr", 6)==0) {
+      if (strncasecmp_P(keyword, PSTR("verstr"), 6)==0) {
         dataPort.println(gpibBus.cfg.vstr);
         return;
       }
-      if (strncasecmp(keyword, "fwver", 6)==0) {
+      if (strncasecmp_P(keyword, PSTR("fwver"), 6)==0) {
         dataPort.println(F(FWVER));
         return;
       }
-      if (strncasecmp(keyword, "name", 4)==0) {
+      if (strncasecmp_P(keyword, PSTR("name"), 4)==0) {
         dataPort.println(gpibBus.cfg.sname);
         return;      
       } void addr_h(char *params);
-      if (strncasecmp(keyword, "serial", 6)==0) {
+      if (strncasecmp_P(keyword, PSTR("serial"), 6)==0) {
         memset(serialStr, '\0', 10);
-        snprintf(serialStr, 10, "%09lu", gpibBus.cfg.serial);  // Max str length = 10-1 i.e 9 digits + null terminator 
+        snprintf_P(serialStr, 10, PSTR("%09lu"), gpibBus.cfg.serial);  // Max str length = 10-1 i.e 9 digits + null terminator 
         dataPort.println(serialStr);
         return;    
       }
@@ -1229,7 +2091,7 @@ void idn_h(char * params) {
     gpibBus.cfg.idn = (uint8_t)val;
     if (isVerbose) {
       dataPort.print(F("Sending IDN: "));
-      dataPort.print(val ? "Enabled" : "Disabled"); 
+      dataPort.print(val ? F("Enabled") : F("Disabled")); 
       if (val==2) dataPort.print(F(" with serial number"));
       dataPort.println();
     };
@@ -1293,42 +2155,14 @@ void untalk_h() {
   gpibBus.setControls(CIDS);
 }
 
-void attnRequired() {
-
-  const uint8_t cmdbuflen = 35;
-  uint8_t cmdbytes[5] = {0};
-  uint8_t db = 0;
-  bool eoiDetected = false;
-  uint8_t gpibcmd = 0;
-  uint8_t bytecnt = 0;
-  uint8_t atnstat = 0;
-  uint8_t ustat = 0;
-  bool addressed = false;
-
-#ifdef EN_STORAGE
-  uint8_t saddrcmd = 0;
-#endif
-
-  // Set device listner active state (assert NDAC+NRFD (low), DAV=INPUT_PULLUP)
-  gpibBus.setControls(DLAS);
-
-  // Read bytes received while ATN is asserted
-  while ( (gpibBus.isAsserted(ATN)) && (bytecnt<cmdbuflen) ) {
-    if (gpibBus.readByte(&db, false, &eoiDetected) > 0 ) break;
-    switch (db) {
-      case 0x3F:  
-        ustat |= 0x01;
-        break;
-      case 0x5F:
-        ustat |= 0x02;
-        break;
-      default:
-        cmdbytes[bytecnt] = db;
-        bytecnt++;
-    }
-  }
+/***** Act on the command phase decoded by GPIBbus::decodeAtn() *****/
+/*
+ * Addressing, serial poll enable/disable and the serial poll response itself
+ * have already been handled as the command bytes were received.
+ */
+void attnRequired(uint8_t dstate, uint8_t saddr) {
 
-  atnstat |= 0x01;
+  saddr = saddr;  // Only used for storage commands
 
   if (isProm) {
     device_listen_h();
@@ -1336,116 +2170,39 @@ void attnRequired() {
     return;
   }
 
-  if (ustat & 0x01) {
-    if (!device_unl_h()) ustat &= 0x01; // Clears bit if UNL was not required
-  }
-
-  if (ustat & 0x01) {
-    if (!device_unt_h()) ustat &= 0x02; // Clears bit if UNT was not required
+  if (dstate & DEV_SDC) {
+    device_sdc_h();
+    return;
   }
 
-  if (bytecnt>0) {
-    for (uint8_t i=0; i<bytecnt; i++) { 
-      if (!cmdbytes[i]) break;  // End loop on zero
-      db = cmdbytes[i];
-
-      if (gpibBus.cfg.paddr == (db ^ 0x20)) { // MLA = db^0x20
-        atnstat |= 0x02;
-        addressed = true;
-        gpibBus.setControls(DLAS);
-      } else if (gpibBus.cfg.paddr == (db ^ 0x40)) { // MLA = db^0x40
-        // Call talk handler to send data
-        atnstat |= 0x04;
-        addressed = true;
-        gpibBus.setControls(DTAS);
-
 #ifdef EN_STORAGE
-      } else if (db>0x5F && db<0x80) {
-        // Secondary addressing command received
-        saddrcmd = db;
-        atnstat |= 0x10;
-#endif
-      }else if (db<0x20){
-        // Primary command received
-        gpibcmd = db;
-        atnstat |= 0x08;
-      }
-    }
-  }
-
-  if (!addressed) {
-    gpibBus.setControls(DINI);
+  // If we have a secondary address then perform secondary GPIB command actions *****/
+  if (dstate & DEV_SADDR) {
+    storage.storeExecCmd(saddr);
     return;
   }
-
-  /***** If addressed, then perform the appropriate actions *****/
-  if (addressed) {
-    if (gpibcmd) {
-      execGpibCmd(gpibcmd);
-      gpibcmd = 0;
-      atnstat |= 0x20;
-      return;      
-    }
-
-#ifdef EN_STORAGE
-    // If we have a secondary address then perform secondary GPIB command actions *****/
-    if (addressed && saddrcmd) {
-      // Execute the GPIB secondary addressing command
-      storage.storeExecCmd(saddrcmd);
-      // Clear secondary address command
-      saddrcmd = 0;
-      atnstat |= 0x40;
-      return;
-    }
 #endif
 
-    // If no GPIB commands but addressed to listen then just listen
-    if (gpibBus.isDeviceAddressedToListen()) {
-      device_listen_h();
-      atnstat |= 0x80;
-      gpibBus.setControls(DIDS);
-      return;
-    }
-  
-    // If no GPIB commands but addressed to talk then send data
-    if (gpibBus.isDeviceAddressedToTalk()) {
-      device_talk_h();
-      atnstat |= 0x80;
-      gpibBus.setControls(DIDS);
-      return;
-    }
-  }
-}
+  // Serial poll status has already been sent
+  if (dstate & DEV_SPOLL) return;
 
-void execGpibCmd(uint8_t gpibcmd){
+  // If addressed to listen then just listen
+  if (dstate & DEV_LISTEN) {
+    device_listen_h();
+    gpibBus.setControls(DIDS);
+    return;
+  }
 
-  // Respond to GPIB command
-  switch (gpibcmd) {
-    case GC_SPE:
-      // Serial Poll enable request
-        device_spe_h();
-        break;
-      case GC_SPD:
-        // Serial poll disable request
-        device_spd_h();
-        break;       
-    case GC_UNL:
-        // Unlisten
-        device_unl_h();
-        break;
-    case GC_UNT:
-        // Untalk
-        device_unt_h();
-        break;
-    case GC_SDC:
-        // Device clear (reset)
-        device_sdc_h();
-        break;
+  // If addressed to talk then send data
+  if (dstate & DEV_TALK) {
+    device_talk_h();
+    gpibBus.setControls(DIDS);
+    return;
   }
 }
 
 void device_listen_h(){
-  gpibBus.receiveData(dataPort, false, false, 0x0);
+  gpibBus.receiveData(dataPort, false);
 }
 
 void device_talk_h(){
@@ -1462,39 +2219,111 @@ void device_sdc_h() {
   if (isVerbose) dataPort.println(F("Reset failed."));
 }
 
-void device_spd_h() {
-  gpibBus.setControls(DIDS);
+#ifdef USE_CAPTURE
+/***** Send capture records as a frame *****/
+/*
+ * Frame: CAP_SYNC, record count, count x {data, flags, dt low, dt high}, checksum
+ * The checksum is the 8 bit sum of the count and record bytes.
+ */
+void sendCapFrame(uint8_t tail, uint8_t cnt) {
+  uint8_t frec[4];
+  uint8_t sum = cnt;
+  struct capRec *rec;
+
+  dataPort.write(CAP_SYNC);
+  dataPort.write(cnt);
+  for (uint8_t i = 0; i < cnt; i++) {
+    rec = &capBuf[(uint8_t)(tail + i) & (CAP_SIZE - 1)];
+    frec[0] = rec->db;
+    frec[1] = rec->flags;
+    // Delta time is sent low byte first
+    frec[2] = lowByte(rec->dt);
+    frec[3] = highByte(rec->dt);
+    dataPort.write(frec, 4);
+    sum += frec[0] + frec[1] + frec[2] + frec[3];
+  }
+  dataPort.write(sum);
 }
 
-void device_spe_h() {
-  gpibBus.sendStatus();
+/***** Capture all bus traffic into the ring buffer *****/
+/*
+ * Each byte is accepted as a listener and recorded with the ATN, EOI and SRQ
+ * state and the time since the previous byte. Records are sent to the host
+ * in frames. When the buffer is full the talker is held off with NRFD until
+ * a frame has been sent, so no bytes are lost.
+ */
+void captureMode() {
+
+  uint8_t head = 0;
+  uint8_t tail = 0;
+  uint8_t cnt;
+  uint8_t db = 0;
+  uint8_t flags;
+  bool eoiDetected = false;
+  unsigned long now;
+  unsigned long dt;
+  unsigned long tlast = micros();
+  unsigned long tact = tlast;
+
+  // Set bus for device read mode
+  gpibBus.setControls(DLAS);
 
-  if (gpibBus.cfg.stat & 0x40) {
-    gpibBus.setStatus(gpibBus.cfg.stat & ~0x40);
-  }
-}
+  while (isRO == 2) {
+
+    cnt = head - tail;
+
+    if (cnt < CAP_SIZE) {
+      // Ready for the next byte - unassert NRFD
+      gpibBus.setControlVal(0b00000100, 0b00000100, 0);
+
+      // DAV asserted - talker has placed a byte on the bus
+      if (!(getGpibHsLines() & HS_DAV)) {
+        flags = gpibBus.isAsserted(ATN) ? CAP_ATN : 0;
+        if (gpibBus.isAsserted(SRQ)) flags |= CAP_SRQ;
+        if (gpibBus.readByte(&db, true, &eoiDetected) == 0) {
+          now = micros();
+          dt = now - tlast;
+          tlast = now;
+          tact = now;
+          if (dt > 0xFFFF) {
+            dt = 0xFFFF;
+            flags |= CAP_DTOVF;
+          }
+          if (eoiDetected) flags |= CAP_EOI;
+          capBuf[head & (CAP_SIZE - 1)].db = db;
+          capBuf[head & (CAP_SIZE - 1)].flags = flags;
+          capBuf[head & (CAP_SIZE - 1)].dt = (uint16_t)dt;
+          head++;
+          cnt++;
+        }
+      }
+    }
 
+    // Send a frame when enough records are waiting or the bus has gone quiet
+    if ((cnt >= CAP_BATCH) || (cnt && ((unsigned long)(micros() - tact) > CAP_IDLE_US))) {
+      sendCapFrame(tail, cnt);
+      tail += cnt;
+    }
 
-/***** Unlisten *****/
-bool device_unl_h() {
-  readWithEoi = false;
-  tranBrk = 3;  // Stop receving transmission
+    if (dataPort.available()) {
 
-  if (gpibBus.isDeviceAddressedToListen()) {
-    gpibBus.setControls(DIDS);
-    return true;
-  }
-  return false;
-}
+      lnRdy = serialIn_h();
 
-bool device_unt_h() {
-  if (gpibBus.isDeviceAddressedToTalk()) {
-    gpibBus.setControls(DIDS);
-    gpibBus.clearDataBus();
-    return true;
+      // We have a command return to main loop and execute it
+      if (lnRdy==1) break;
+
+      // Clear the buffer to prevent it getting blocked
+      if (lnRdy==2) flushPbuf();
+    }
   }
-  return false;
+
+  // Send anything still in the buffer
+  cnt = head - tail;
+  if (cnt) sendCapFrame(tail, cnt);
+
+  gpibBus.setControls(DIDS);
 }
+#endif  // USE_CAPTURE
 
 void lonMode() {
 
@@ -1505,7 +2334,7 @@ void lonMode() {
   // Set bus for device read mode
   gpibBus.setControls(DLAS);
 
-  while (isRO) {
+  while (isRO == 1) {
 
     r = gpibBus.readByte(&db, false, &eoiDetected);
     if (r == 0) dataPort.write(db);
@@ -1549,7 +2378,7 @@ void tonMode() {
 
         // Otherwise send the buffered data
         if (lnRdy==2) {
-          for (uint8_t i=0; i<pbPtr; i++){
+          for (uint16_t i=0; i<pbPtr; i++){
             gpibBus.writeByte(pBuf[i], false);  // False = No EOI
           }
           flushPbuf();
@@ -0,0 +1,214 @@
+#ifndef AR488_BOARD_H
+#define AR488_BOARD_H
+
+#include <Arduino.h>
+
+#include "AR488_Config.h"
+
+/***** Compile time board descriptor *****/
+/*
+ * The Arduino pin numbers of the data and control lines (AR488_CUSTOM or one of
+ * the layouts in AR488_Layouts.h) are resolved at compile time into the port and
+ * bit of the MCU. Each bus is then read and written one port at a time using the
+ * PINx/PORTx/DDRx registers. The bits of a bus byte landing on one port are
+ * grouped by the distance they move, so each group costs a single mask and shift
+ * (none at all when a port bit matches its position in the bus byte, e.g. the
+ * Uno data bus). The positions are all constants so no loops or pin lookups
+ * remain at run time.
+ */
+
+#if defined(__AVR_ATmega2560__)
+// Arduino Mega 2560 pins D0-D69 (A0-A15 = D54-D69)
+constexpr char pinPortTbl[70] = {
+  'E','E','E','E','G','E','H','H','H','H','B','B','B','B','J','J',
+  'H','H','D','D','D','D','A','A','A','A','A','A','A','A','C','C',
+  'C','C','C','C','C','C','D','G','G','G','L','L','L','L','L','L',
+  'L','L','B','B','B','B','F','F','F','F','F','F','F','F','K','K',
+  'K','K','K','K','K','K'
+};
+constexpr uint8_t pinBitTbl[70] = {
+   0,  1,  4,  5,  5,  3,  3,  4,  5,  6,  4,  5,  6,  7,  1,  0,
+   1,  0,  3,  2,  1,  0,  0,  1,  2,  3,  4,  5,  6,  7,  7,  6,
+   5,  4,  3,  2,  1,  0,  7,  2,  1,  0,  7,  6,  5,  4,  3,  2,
+   1,  0,  3,  2,  1,  0,  0,  1,  2,  3,  4,  5,  6,  7,  0,  1,
+   2,  3,  4,  5,  6,  7
+};
+constexpr char pinPort(uint8_t pin) { return (pin < 70) ? pinPortTbl[pin] : 0; }
+constexpr uint8_t pinBit(uint8_t pin) { return (pin < 70) ? pinBitTbl[pin] : 0; }
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+// Arduino Uno/Nano pins D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 (D14-D19) = PORTC
+constexpr char pinPort(uint8_t pin) { return (pin < 8) ? 'D' : (pin < 14) ? 'B' : (pin < 20) ? 'C' : 0; }
+constexpr uint8_t pinBit(uint8_t pin) { return (pin < 8) ? pin : (pin < 14) ? pin - 8 : pin - 14; }
+#else
+// Arduino Leonardo/Micro/Pro Micro pins D0-D30
+constexpr char pinPortTbl[31] = {
+  'D','D','D','D','D','C','D','E','B','B','B','B','D','C','B','B',
+  'B','B','F','F','F','F','F','F','D','D','B','B','B','D','D'
+};
+constexpr uint8_t pinBitTbl[31] = {
+   2,  3,  1,  0,  4,  6,  7,  6,  4,  5,  6,  7,  6,  7,  3,  1,
+   2,  0,  7,  6,  5,  4,  1,  0,  4,  7,  4,  5,  6,  6,  5
+};
+constexpr char pinPort(uint8_t pin) { return (pin < 31) ? pinPortTbl[pin] : 0; }
+constexpr uint8_t pinBit(uint8_t pin) { return (pin < 31) ? pinBitTbl[pin] : 0; }
+#endif
+
+constexpr uint8_t dbusPins[8] = { DIO1, DIO2, DIO3, DIO4, DIO5, DIO6, DIO7, DIO8 };
+constexpr uint8_t ctrlPins[8] = { IFC, NDAC, NRFD, DAV, EOI, REN, SRQ, ATN };
+
+constexpr uint8_t busPin(bool ctrl, uint8_t i) { return ctrl ? ctrlPins[i] : dbusPins[i]; }
+// Port bit used by bus bit i if it is on port P, otherwise 0
+constexpr uint8_t portBit(char P, bool ctrl, uint8_t i) {
+  return (pinPort(busPin(ctrl, i)) == P) ? (1 << pinBit(busPin(ctrl, i))) : 0;
+}
+// All bits of the bus that are on port P
+constexpr uint8_t portMask(char P, bool ctrl, uint8_t i = 0) {
+  return (i < 8) ? (portBit(P, ctrl, i) | portMask(P, ctrl, i + 1)) : 0;
+}
+// Bits of the bus byte that are on port P, d places to the left of their bus position
+constexpr uint8_t shiftMask(char P, bool ctrl, int8_t d, uint8_t i = 0) {
+  return (i < 8) ? ((((pinPort(busPin(ctrl, i)) == P) && (pinBit(busPin(ctrl, i)) == i + d)) ? (1 << i) : 0) | shiftMask(P, ctrl, d, i + 1)) : 0;
+}
+constexpr uint8_t shiftBy(uint8_t v, int8_t d) { return (d >= 0) ? (uint8_t)(v << d) : (uint8_t)(v >> -d); }
+constexpr bool pinsValid(bool ctrl, uint8_t i = 0) {
+  return (i < 8) ? ((pinPort(busPin(ctrl, i)) != 0) && pinsValid(ctrl, i + 1)) : true;
+}
+
+static_assert(pinsValid(false), "DIO1-DIO8 must be digital pins of this board");
+static_assert(pinsValid(true), "GPIB control pins must be digital pins of this board");
+
+template<char P> struct GpibPort;
+#define GPIB_PORT(P) \
+  template<> struct GpibPort<#P[0]> { \
+    static volatile uint8_t& pin() { return PIN##P; } \
+    static volatile uint8_t& ddr() { return DDR##P; } \
+    static volatile uint8_t& port() { return PORT##P; } \
+  };
+GPIB_PORT(B)
+GPIB_PORT(C)
+GPIB_PORT(D)
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega32U4__)
+GPIB_PORT(E)
+GPIB_PORT(F)
+#endif
+#if defined(__AVR_ATmega2560__)
+GPIB_PORT(A)
+GPIB_PORT(G)
+GPIB_PORT(H)
+GPIB_PORT(J)
+GPIB_PORT(K)
+GPIB_PORT(L)
+#endif
+#undef GPIB_PORT
+
+/***** Move bus byte bits to and from their port P positions *****/
+/*
+ * One term for each distance D (-7 to 7) that any bit moves by. Terms with no
+ * bits are folded away by the compiler.
+ */
+template<char P, bool CTRL, int8_t D = -7> struct PortMap {
+  static inline uint8_t to(uint8_t v) {
+    return (shiftMask(P, CTRL, D) ? shiftBy(v & shiftMask(P, CTRL, D), D) : 0) | PortMap<P, CTRL, D + 1>::to(v);
+  }
+  static inline uint8_t from(uint8_t r) {
+    return (shiftMask(P, CTRL, D) ? shiftBy(r & shiftBy(shiftMask(P, CTRL, D), D), -D) : 0) | PortMap<P, CTRL, D + 1>::from(r);
+  }
+};
+template<char P, bool CTRL> struct PortMap<P, CTRL, 8> {
+  static inline uint8_t to(uint8_t) { return 0; }
+  static inline uint8_t from(uint8_t) { return 0; }
+};
+
+/***** Port updates *****/
+/*
+ * The PORTx/DDRx updates are read-modify-write. The ATN interrupt asserts
+ * NRFD through setCtrl(), so on a port that carries control lines an update
+ * interrupted between the read and the write would put back a stale value.
+ * Those updates run with interrupts disabled.
+ */
+template<char P> inline void readyDbusPort() {
+  constexpr uint8_t m = portMask(P, false);
+  if (m) {
+    uint8_t sreg = SREG;
+    if (portMask(P, true)) cli();
+    GpibPort<P>::ddr() &= ~m;
+    GpibPort<P>::port() |= m;
+    SREG = sreg;
+  }
+}
+
+template<char P> inline uint8_t readDbusPort() {
+  if (!portMask(P, false)) return 0;
+  return PortMap<P, false>::from(GpibPort<P>::pin());
+}
+
+template<char P> inline void setDbusPort(uint8_t db) {
+  constexpr uint8_t m = portMask(P, false);
+  if (m) {
+    uint8_t sreg = SREG;
+    if (portMask(P, true)) cli();
+    GpibPort<P>::ddr() |= m;
+    GpibPort<P>::port() = (GpibPort<P>::port() & ~m) | PortMap<P, false>::to(db);
+    SREG = sreg;
+  }
+}
+
+template<char P> inline void setCtrlPort(uint8_t bits, uint8_t mask, uint8_t mode) {
+  if (!portMask(P, true)) return;
+  uint8_t pm = PortMap<P, true>::to(mask);
+  if (!pm) return;
+  uint8_t pb = PortMap<P, true>::to(bits);
+  uint8_t sreg = SREG;
+  cli();
+  switch (mode) {
+    case 0:
+      // Set pin states using mask
+      GpibPort<P>::port() = (GpibPort<P>::port() & ~pm) | (pb & pm);
+      break;
+    case 1:
+      // Set pin direction using mask, inputs with pullup
+      GpibPort<P>::ddr() = (GpibPort<P>::ddr() & ~pm) | (pb & pm);
+      GpibPort<P>::port() |= (pm & ~pb);
+      break;
+  }
+  SREG = sreg;
+}
+
+template<char P> inline uint8_t readHsPort() {
+  if (!(portMask(P, true) & PortMap<P, true>::to(0b00011110))) return 0;
+  return PortMap<P, true>::from(GpibPort<P>::pin());
+}
+
+
+/***** The ports of the board *****/
+/*
+ * Ports that carry no GPIB lines compile to nothing.
+ */
+template<char... P> struct BusPorts;
+template<> struct BusPorts<> {
+  static inline void readyDbus() {}
+  static inline uint8_t readDbus() { return 0; }
+  static inline void setDbus(uint8_t) {}
+  static inline void setCtrl(uint8_t, uint8_t, uint8_t) {}
+  static inline uint8_t readHs() { return 0; }
+};
+template<char P, char... R> struct BusPorts<P, R...> {
+  static inline void readyDbus() { readyDbusPort<P>(); BusPorts<R...>::readyDbus(); }
+  static inline uint8_t readDbus() { return readDbusPort<P>() | BusPorts<R...>::readDbus(); }
+  static inline void setDbus(uint8_t db) { setDbusPort<P>(db); BusPorts<R...>::setDbus(db); }
+  static inline void setCtrl(uint8_t bits, uint8_t mask, uint8_t mode) {
+    setCtrlPort<P>(bits, mask, mode);
+    BusPorts<R...>::setCtrl(bits, mask, mode);
+  }
+  static inline uint8_t readHs() { return readHsPort<P>() | BusPorts<R...>::readHs(); }
+};
+
+#if defined(__AVR_ATmega2560__)
+typedef BusPorts<'A','B','C','D','E','F','G','H','J','K','L'> BoardPorts;
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+typedef BusPorts<'B','C','D'> BoardPorts;
+#else
+typedef BusPorts<'B','C','D','E','F'> BoardPorts;
+#endif
+
+#endif // AR488_BOARD_H
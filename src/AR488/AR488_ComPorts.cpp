@@ -1,12 +1,113 @@
 #include <Arduino.h>
 #include "AR488_ComPorts.h"
+#include "AR488_Layouts.h"
 
 #ifdef DATAPORT_ENABLE
+  #if defined(AR_SERIAL_RTS_PIN) || defined(AR_SERIAL_CTS_PIN)
+    /***** The flow control pins must not be GPIB pins of the layout *****/
+    constexpr uint8_t gpibPins[16] = { DIO1, DIO2, DIO3, DIO4, DIO5, DIO6, DIO7, DIO8, IFC, NDAC, NRFD, DAV, EOI, REN, SRQ, ATN };
+    constexpr bool isGpibPin(uint8_t pin, uint8_t i = 0) {
+      return (i < 16) && ((gpibPins[i] == pin) || isGpibPin(pin, i + 1));
+    }
+  #endif
+  #ifdef AR_SERIAL_RTS_PIN
+    static_assert(!isGpibPin(AR_SERIAL_RTS_PIN), "AR_SERIAL_RTS_PIN is a GPIB pin of the selected layout");
+  #endif
+  #ifdef AR_SERIAL_CTS_PIN
+    static_assert(!isGpibPin(AR_SERIAL_CTS_PIN), "AR_SERIAL_CTS_PIN is a GPIB pin of the selected layout");
+  #endif
+
+  #ifdef AR_SERIAL_CTS_PIN
+    uint32_t dataPortDropped = 0;   // Output bytes dropped after a CTS timeout
+    static bool ctsTimedOut = false;
+
+    /***** Wait for the host to assert (LOW) CTS *****/
+    /*
+     * Gives up after AR_SERIAL_CTS_TMO milliseconds so that a host that has
+     * stopped reading cannot hang the interface. Until CTS is asserted again
+     * further output is dropped without waiting.
+     */
+    static bool waitCts() {
+      unsigned long tstart;
+
+      if (digitalRead(AR_SERIAL_CTS_PIN) == LOW) {
+        ctsTimedOut = false;
+        return true;
+      }
+      if (ctsTimedOut) return false;
+      tstart = millis();
+      while (digitalRead(AR_SERIAL_CTS_PIN) == HIGH) {
+        if ((millis() - tstart) >= AR_SERIAL_CTS_TMO) {
+          ctsTimedOut = true;
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /***** Serial port wrapper that waits for CTS before each write *****/
+    class FlowPort : public Stream {
+      public:
+        int available() { return AR_SERIAL_PORT.available(); }
+        int read() { return AR_SERIAL_PORT.read(); }
+        int peek() { return AR_SERIAL_PORT.peek(); }
+        void flush() { AR_SERIAL_PORT.flush(); }
+        size_t write(uint8_t c) {
+          if (waitCts()) return AR_SERIAL_PORT.write(c);
+          dataPortDropped++;
+          return 0;
+        }
+        size_t write(const uint8_t *buffer, size_t size) {
+          // CTS is checked once for the block, the host adapter buffers the rest
+          if (waitCts()) return AR_SERIAL_PORT.write(buffer, size);
+          dataPortDropped += size;
+          return 0;
+        }
+        using Print::write;
+    };
+
+    FlowPort flowPort;
+    Stream& dataPort = flowPort;
+  #else
     Stream& dataPort = AR_SERIAL_PORT;
+  #endif
 
     void startDataPort() {
       AR_SERIAL_PORT.begin(AR_SERIAL_SPEED);
+  #ifdef AR_SERIAL_CTS_PIN
+      pinMode(AR_SERIAL_CTS_PIN, INPUT_PULLUP);
+  #endif
+  #ifdef AR_SERIAL_RTS_PIN
+      pinMode(AR_SERIAL_RTS_PIN, OUTPUT);
+      digitalWrite(AR_SERIAL_RTS_PIN, HIGH);
+      setDataPortReady(true);
+  #endif
     }  
+
+  #ifdef AR_SERIAL_RTS_PIN
+    static bool dataPortHeld = false;   // Input is waiting to be processed
+    static bool rtsReady = false;
+
+    /***** Input has been handed over for processing (false) or processed (true) *****/
+    void setDataPortReady(bool ready) {
+      dataPortHeld = !ready;
+      checkDataPortFlow();
+    }
+
+    /***** Assert (LOW) or de-assert (HIGH) RTS *****/
+    /*
+     * RTS is de-asserted while input is being processed and whenever the
+     * serial input buffer holds AR_SERIAL_RTS_LEVEL or more characters, so the
+     * host stops before the buffer overruns even while the interface is not
+     * reading it (e.g. during a long GPIB read).
+     */
+    void checkDataPortFlow() {
+      bool ready = !dataPortHeld && (AR_SERIAL_PORT.available() < AR_SERIAL_RTS_LEVEL);
+      if (ready == rtsReady) return;
+      digitalWrite(AR_SERIAL_RTS_PIN, ready ? LOW : HIGH);
+      rtsReady = ready;
+    }
+  #endif
 #else
   DEVNULL _dndata;
   Stream& dataPort = _dndata;
@@ -29,7 +130,7 @@
   
   void printHex(uint8_t byteval) {
     char x[4] = {'\0'};
-    sprintf(x,"%02X ", byteval);
+    sprintf_P(x, PSTR("%02X "), byteval);
     debugPort.print(x);
   }
 
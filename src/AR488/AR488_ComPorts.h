@@ -18,10 +18,35 @@
   #define DATA_RAW_PRINT(str) dataPort.print(str)
   #define DATA_RAW_PRINTLN(str) dataPort.println(str)
 
+  // RTS flow control - hold off the host while input is being processed or
+  // the serial input buffer is filling up
+  #ifdef AR_SERIAL_RTS_PIN
+    #ifndef AR_SERIAL_RTS_LEVEL
+      #define AR_SERIAL_RTS_LEVEL 32   // Half of the 64 byte AVR serial input buffer
+    #endif
+    void setDataPortReady(bool ready);
+    void checkDataPortFlow();
+    #define DATAPORT_READY(ready) setDataPortReady(ready)
+    #define DATAPORT_FLOW() checkDataPortFlow()
+  #else
+    #define DATAPORT_READY(ready)
+    #define DATAPORT_FLOW()
+  #endif
+
+  // CTS flow control - output is dropped if the host holds CTS for too long
+  #ifdef AR_SERIAL_CTS_PIN
+    #ifndef AR_SERIAL_CTS_TMO
+      #define AR_SERIAL_CTS_TMO 1000   // Milliseconds
+    #endif
+    extern uint32_t dataPortDropped;
+  #endif
+
 #else
   extern Stream& dataPort;
 
   #define DATAPORT_START()
+  #define DATAPORT_READY(ready)
+  #define DATAPORT_FLOW()
   #define DATA_RAW_PRINT(str)
   #define DATA_RAW_PRINTLN(str)
 #endif  // DATAPORT_ENABLE
@@ -8,22 +8,48 @@
 //#define DEBUG_ENABLE
 
 #ifdef AR488_CUSTOM
-#define __AVR_ATmega32U4__
+// Select ONE layout, or none to use the custom pins defined below. The board
+// (MCU) itself is set by the board selected in the IDE.
 #define AR488_MEGA32U4_MICRO  // Artag's design for Micro board
+//#define AR488_MEGA32U4_HANDWIRE // Artag's hand wired Pro Micro
+//#define AR488_UNO             // Artag's Uno/Nano layout
+//#define AR488_MEGA2560        // Artag's Mega 2560 layout
 #endif  // Board/layout selection
 
+// The pins of these layouts are defined in AR488_Layouts.h
+#if (defined(AR488_MEGA32U4_MICRO) + defined(AR488_MEGA32U4_HANDWIRE) + defined(AR488_UNO) + defined(AR488_MEGA2560)) > 1
+  #error "Select only one board layout in AR488_Config.h"
+#elif defined(AR488_MEGA32U4_MICRO) || defined(AR488_MEGA32U4_HANDWIRE) || defined(AR488_UNO) || defined(AR488_MEGA2560)
+  #define AR488_BOARD_LAYOUT
+#endif
+
 #ifdef DATAPORT_ENABLE
   // Serial port device
   #define AR_SERIAL_PORT Serial
   // #define AR_SERIAL_SWPORT
   // Set port operating speed
   #define AR_SERIAL_SPEED 115200
+  // Hardware flow control (UART ports only - USB CDC ports do not need it).
+  // The pins must not be used by the layout: A4/A5 are free on the 32u4
+  // layouts, use e.g. 6 and 13 on the Uno layout.
+  //#define AR_SERIAL_RTS_PIN A4   // Output: LOW when the interface can accept data
+  //#define AR_SERIAL_CTS_PIN A5   // Input: held LOW by the host when it can accept data
+  //#define AR_SERIAL_RTS_LEVEL 32 // De-assert RTS when this many characters are waiting
+  //#define AR_SERIAL_CTS_TMO 1000 // Drop output if CTS is held HIGH for longer (ms)
   // Enable Bluetooth (HC05) module?
   //#define AR_SERIAL_BT_ENABLE 12        // HC05 enable pin
   //#define AR_SERIAL_BT_NAME "AR488-BT"  // Bluetooth device name
   //#define AR_SERIAL_BT_CODE "488488"    // Bluetooth pairing code
 #endif
 
+/***** USBTMC interface *****/
+/*
+ * On boards with native USB (32u4) a USBTMC interface can be presented
+ * alongside the CDC serial port (see AR488_USBTMC.h). It is used in
+ * controller mode and talks to the currently addressed instrument.
+ */
+//#define AR488_USBTMC
+
 /***** Debug port *****/
 #ifdef DEBUG_ENABLE
   // Serial port device
@@ -65,8 +91,52 @@
   //#define DEBUG_BLUETOOTH       // bluetooth
 #endif
 
-#ifdef AR488_CUSTOM
+/***** Bus trace *****/
+// Log bus events to a RAM buffer (read with ++trace) without affecting timing
+//#define TRACE_ENABLE
+#ifdef TRACE_ENABLE
+  #define TRACE_SIZE 32   // Number of 6-byte records (power of 2, max 128)
+#endif
+
+/***** HS488 handshake timing (++hs488) *****/
+#define HS488_T1_US 1       // Data settling time before DAV is asserted
+#define HS488_HOLD_US 2     // Longest time DAV is held when the listener does not assert NRFD
+#define HS488_WINDOW_US 20  // Time allowed for the listener's HS488 NDAC pulse
+
+/***** Simulated bus *****/
+// Replace the GPIB pins with virtual instruments to measure handshake cost (++simbus)
+//#define AR488_SIMBUS
+#ifdef AR488_SIMBUS
+  #define SIM_ADDR 10       // Address of the first virtual instrument
+  #define SIM_DEVICES 2     // Number of virtual instruments
+  #define SIM_MSG_LEN 1000  // Default length of an instrument response
+#endif
+
+/***** I/O buffers *****/
+/*
+ * RAM for the host and GPIB buffers is taken from a fixed budget so that a
+ * change of size cannot silently push the stack into the globals on the 32u4
+ * (2.5K) or 328P (2K). The sizes are checked against IO_BUDGET at compile
+ * time, including the trace and USBTMC buffers when they are enabled.
+ */
+#define IO_BUDGET 768         // Bytes of RAM set aside for the buffers below
+#define PBSIZE 256            // Host command/data line buffer
+#define GPIB_RXBUF_SIZE 64    // GPIB receive staging buffer (64 = one USB full speed packet, max 255)
+
+/***** Bus capture (++lon 2) *****/
+// The capture buffer takes CAP_SIZE x 4 bytes of the budget above
+//#define USE_CAPTURE
+#ifdef USE_CAPTURE
+  #define CAP_SIZE 64         // Capture records of 4 bytes (power of 2, max 128)
+#endif
+
+#if defined(AR488_CUSTOM) && !defined(AR488_BOARD_LAYOUT)
 
+/*
+ * On Uno/Nano (328P), Leonardo/Micro (32u4) and Mega 2560 boards these pins are
+ * resolved to PORTx/PINx/DDRx bits at compile time (see AR488_Board.h). On other
+ * boards the Arduino pin functions are used.
+ */
 #define DIO1  A0  /* GPIB 1  */
 #define DIO2  A1  /* GPIB 2  */
 #define DIO3  A2  /* GPIB 3  */
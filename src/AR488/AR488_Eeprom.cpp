@@ -2,7 +2,6 @@
 #include <EEPROM.h>
 #include "AR488_Eeprom.h"
 
-uint16_t getCRC16(uint8_t bytes[], uint16_t bsize);
 unsigned long int getCRC32(uint8_t bytes[], uint16_t bsize);
 
 #ifdef __AVR__
@@ -16,70 +15,157 @@ void epViewData(Stream& outputStream) {
   // Read data
   memset(dbuf, 0x00, 16);
   for (addr=0; addr<EESIZE; addr=addr+16){
-    sprintf(cnt, "%03d", addr);
+    sprintf_P(cnt, PSTR("%03d"), addr);
     outputStream.print(cnt);
-    outputStream.print(":");
+    outputStream.print(':');
     EEPROM.get(addr, dbuf);
     for (int i=0; i<16; i++){
-      outputStream.print(" ");
-      sprintf(oct, "%02X", dbuf[i]);
+      outputStream.print(' ');
+      sprintf_P(oct, PSTR("%02X"), dbuf[i]);
       outputStream.print(oct);
     }
     outputStream.println();
   }
 }
 
+/***** Config store layout *****/
+/*
+ * The EEPROM is divided into as many slots as will fit, each holding a small
+ * header followed by a copy of the config. Each save goes to the slot after
+ * the current one with the next sequence number, so that writes are spread
+ * over the whole EEPROM. At power-up only the headers are scanned to find the
+ * current slot and only that copy is read and checked against its CRC. If a
+ * save was interrupted, the previous copy is used.
+ */
+#define EP_MAGIC 0xA4
+
+struct epHdr {
+  uint8_t magic;
+  uint8_t seq;      // Sequence number of the save
+  uint16_t crc;     // CRC16 of the config data
+};
+
+static int16_t epCurSlot = -1;   // Slot holding the current config (-1 = not known)
+
+
+static uint8_t epSlots(uint16_t cfgsize) {
+  return EESIZE / (sizeof(epHdr) + cfgsize);
+}
+
+static uint16_t epSlotAddr(uint8_t slot, uint16_t cfgsize) {
+  return slot * (sizeof(epHdr) + cfgsize);
+}
+
+static bool epGetHdr(uint8_t slot, uint16_t cfgsize, epHdr &hdr) {
+  EEPROM.get(epSlotAddr(slot, cfgsize), hdr);
+  return (hdr.magic == EP_MAGIC);
+}
+
+/***** Find the most recently written slot from the headers *****/
+/*
+ * The current slot is the one that is not followed by the next sequence number
+ */
+static int16_t epFindSlot(uint16_t cfgsize, epHdr &hdr) {
+  uint8_t n = epSlots(cfgsize);
+  epHdr nhdr;
+
+  for (uint8_t i=0; i<n; i++) {
+    if (!epGetHdr(i, cfgsize, hdr)) continue;
+    if (!epGetHdr((i + 1) % n, cfgsize, nhdr)) return i;
+    if (nhdr.seq != (uint8_t)(hdr.seq + 1)) return i;
+  }
+  return -1;
+}
+
 void epErase() {
   int i = EESIZE;
 
   // Load EEPROM data from Flash
   for (i=0; i<EESIZE; i++)
     EEPROM.write(i, 0xFF);
+  epCurSlot = -1;
 }
 
 void epWriteData(uint8_t cfgdata[], uint16_t cfgsize) {
+  epHdr hdr;
   uint16_t crc;
-  uint16_t addr = EESTART;
+  uint16_t addr;
   uint16_t i = 0;
- 
+  uint8_t n = epSlots(cfgsize);
+  bool same = true;
+
+  // Current slot
+  if (epCurSlot < 0) {
+    epCurSlot = epFindSlot(cfgsize, hdr);
+  }else{
+    epGetHdr(epCurSlot, cfgsize, hdr);
+  }
+
+  crc = getCRC16(cfgdata, cfgsize);
+
+  if (epCurSlot >= 0) {
+    // Nothing to do if the config has not changed
+    if (hdr.crc == crc) {
+      addr = epSlotAddr(epCurSlot, cfgsize) + sizeof(epHdr);
+      for (i=0; (i<cfgsize) && same; i++){
+        if (EEPROM.read(addr+i) != cfgdata[i]) same = false;
+      }
+      if (same) return;
+    }
+    // Next slot
+    epCurSlot = (epCurSlot + 1) % n;
+    hdr.seq++;
+  }else{
+    epCurSlot = 0;
+    hdr.seq = 0;
+  }
+
   // Write data
+  addr = epSlotAddr(epCurSlot, cfgsize) + sizeof(epHdr);
   for (i=0; i<cfgsize; i++){
     EEPROM.update(addr+i,cfgdata[i]);
   }
-  // Write CRC
-  crc = getCRC16(cfgdata, cfgsize);
-  EEPROM.put(0, crc);
-  // Commit write to Flash
+  // Write header last so that an interrupted save is not used
+  hdr.magic = EP_MAGIC;
+  hdr.crc = crc;
+  EEPROM.put(epSlotAddr(epCurSlot, cfgsize), hdr);
 }
 
 bool epReadData(uint8_t cfgdata[], uint16_t cfgsize) {
-  uint16_t crc1;
-  uint16_t crc2;
-//  uint16_t addr = EESTART;
+  epHdr hdr;
+  epHdr phdr;
+  int16_t slot;
+  uint16_t addr;
+  uint8_t n = epSlots(cfgsize);
   uint16_t i=0;
 
-  // Read CRC
-  EEPROM.get(0,crc1);
-  // Read data
-  for (i=0;i<cfgsize;i++){
-    cfgdata[i] = EEPROM.read(EESTART+i);
-  }
+  slot = epFindSlot(cfgsize, hdr);
 
-  // Get CRC of config
-  crc2 = getCRC16(cfgdata, cfgsize);
-  if (crc1==crc2) return true;
-  else return false;
+  for (uint8_t j=0; (slot>=0) && (j<n); j++) {
+    // Read data
+    addr = epSlotAddr(slot, cfgsize) + sizeof(epHdr);
+    for (i=0;i<cfgsize;i++){
+      cfgdata[i] = EEPROM.read(addr+i);
+    }
+    // Check CRC of config
+    if (getCRC16(cfgdata, cfgsize) == hdr.crc) {
+      epCurSlot = slot;
+      return true;
+    }
+    // Try the previous save
+    slot = (slot + n - 1) % n;
+    if (!epGetHdr(slot, cfgsize, phdr) || (phdr.seq != (uint8_t)(hdr.seq - 1))) break;
+    hdr = phdr;
+  }
+  return false;
 }
 
 
-bool isEepromClear(){
-  int16_t crc = 0;
+bool isEepromClear(uint16_t cfgsize){
+  epHdr hdr;
 
-  // Load (first 16 bits) data from EEPROM
-  EEPROM.get(0, crc);
-  // Return result
-  if (crc==-1) return true;
-  else return false;
+  // Clear if no slot has been written
+  return (epFindSlot(cfgsize, hdr) < 0);
 }
 #endif
 
@@ -101,9 +187,8 @@ unsigned long int getCRC32(uint8_t bytes[], uint16_t bsize) {
   return crc;
 }
 
-uint16_t getCRC16(uint8_t bytes[], uint16_t bsize){
+uint16_t getCRC16(uint8_t bytes[], uint16_t bsize, uint16_t crc){
   uint8_t x;
-  uint16_t crc = 0xFFFF;
 
   for (uint16_t idx=0; idx<bsize; ++idx) {
     x = crc >> 8 ^ bytes[idx];
@@ -4,7 +4,6 @@
 #include "AR488_Config.h"
 
 #define EESIZE 512
-#define EESTART 2    // EEPROM start of data - min 4 for CRC32, min 2 for CRC16
 #define UPCASE true
 
 const uint16_t eesize = EESIZE;
@@ -13,6 +12,7 @@ void epErase();
 void epWriteData(uint8_t cfgdata[], uint16_t cfgsize);
 bool epReadData(uint8_t cfgdata[], uint16_t cfgsize);
 void epViewData(Stream& outputStream);
-bool isEepromClear();
+bool isEepromClear(uint16_t cfgsize);
+uint16_t getCRC16(uint8_t bytes[], uint16_t bsize, uint16_t crc = 0xFFFF);
 
 #endif // AR488_EEPROM_H
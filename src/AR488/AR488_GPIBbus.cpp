@@ -2,6 +2,7 @@
 //#include <SD.h>
 #include "AR488_Config.h"
 #include "AR488_GPIBbus.h"
+#include "AR488_Trace.h"
 
 #define OK  false
 #define ERR true
@@ -12,10 +13,43 @@
 #define LF   0xA    // Newline/linefeed
 #define PLUS 0x2B   // '+' character
 
+/***** SRQ event queue filled by the SRQ interrupt *****/
+static volatile unsigned long srqTime[GPIB_SRQ_QUEUE_SIZE];
+static volatile uint8_t srqHead = 0;
+static uint8_t srqTail = 0;
+
+static void srqIsr() {
+  uint8_t next = (srqHead + 1) & (GPIB_SRQ_QUEUE_SIZE - 1);
+  // Drop the event if the queue is full
+  if (next != srqTail) {
+    srqTime[srqHead] = micros();
+    srqHead = next;
+  }
+}
+
+/***** Bus instance serviced by the ATN interrupt *****/
+static GPIBbus *atnBus = NULL;
+
+static void atnIsr() {
+  if (atnBus) atnBus->holdAtn();
+}
+
 GPIBbus::GPIBbus(){
   setDefaultCfg();
   cstate = 0;
   deviceAddressed = false;
+  rxLen = 0;
+  fastHs = false;
+  hs488 = false;
+  hsState = HS488_IDLE;
+  stickyAddr = false;
+  addrCache = NO_ADDR_CACHE;
+  heldPending = false;
+  devState = 0;
+  atnSaddr = 0;
+  atnIntr = false;
+  atnHeld = false;
+  clearStats();
 }
 
 void GPIBbus::begin(){
@@ -25,6 +59,7 @@ void GPIBbus::begin(){
 
 void GPIBbus::stop(){
   cstate = 0;
+  addrCache = NO_ADDR_CACHE;
   // Input_pullup
   setGpibState(0b00000000, 0b11111111, 1);
   // All lines HIGH
@@ -39,6 +74,9 @@ void GPIBbus::setDefaultCfg(){
 }
 
 void GPIBbus::startDeviceMode(){
+  // SRQ is an output in device mode
+  disableSrqInterrupt();
+  disableAtnInterrupt();
   // Stop current mode
   stop();
   delayMicroseconds(200); // Allow settling time
@@ -48,9 +86,14 @@ void GPIBbus::startDeviceMode(){
   setControls(DINI);
   // Initialise GPIB data lines (sets to INPUT_PULLUP)
   readyGpibDbus();
+  // Respond to ATN from the interrupt where the pin supports it
+  devState = 0;
+  enableAtnInterrupt();
 }
 
 void GPIBbus::startControllerMode(){
+  // ATN is driven by us in controller mode
+  disableAtnInterrupt();
   // Send request to clear all devices on bus to local mode
   sendAllClear();
   // Stop current mode
@@ -74,8 +117,8 @@ bool GPIBbus::isController(){
 }
 
 bool GPIBbus::isAsserted(uint8_t gpibsig){
-  // Use digitalRead function to get current Arduino pin state
-  return (digitalRead(gpibsig) == LOW) ? true : false;
+  // Get current pin state through the layout functions
+  return (getGpibPinState(gpibsig) == LOW) ? true : false;
 }
 
 void GPIBbus::sendStatus() {
@@ -101,6 +144,9 @@ void GPIBbus::setStatus(uint8_t statusByte){
 }
 
 void GPIBbus::sendIFC(){
+  // IFC unaddresses all devices
+  addrCache = NO_ADDR_CACHE;
+  TRACE(TR_IFC, 0);
   // Assert IFC
   setGpibState(0b00000000, 0b00000001, 0);
   delayMicroseconds(150);
@@ -132,6 +178,18 @@ bool GPIBbus::sendGET(uint8_t addr){
   return OK;
 }
 
+/***** Address a group of devices to listen and trigger them together *****/
+bool GPIBbus::sendGroupGET(uint8_t *addrs, uint8_t cnt){
+  if (sendCmd(GC_UNL)) return ERR;
+  for (uint8_t i = 0; i < cnt; i++) {
+    if (sendCmd(GC_LAD + addrs[i])) return ERR;
+  }
+  if (sendCmd(GC_GET)) return ERR;
+  if (sendCmd(GC_UNL)) return ERR;
+  deviceAddressed = false;
+  return OK;
+}
+
 void GPIBbus::sendAllClear(){
   // Un-assert REN
   setControlVal(0b00100000, 0b00100000, 0);
@@ -178,6 +236,8 @@ bool GPIBbus::sendUNL(){
 
 bool GPIBbus::sendCmd(uint8_t cmdByte){
   bool stat = false;
+  // Any command may change the addressed state
+  addrCache = NO_ADDR_CACHE;
   // Set lines for command and assert ATN
   if (cstate!=CCMS) setControls(CCMS);
   // Send the command
@@ -185,38 +245,26 @@ bool GPIBbus::sendCmd(uint8_t cmdByte){
   return stat ? ERR : OK;
 }
 
-bool GPIBbus::receiveData(Stream& dataStream, bool detectEoi, bool detectEndByte, uint8_t endByte) {
+bool GPIBbus::receiveData(Stream& dataStream, bool detectEoi, readTerm *term) {
 
-  uint8_t r = 0; //, db;
-  uint8_t bytes[3] = {0};
-  uint8_t eor = cfg.eor&7;
-  int x = 0;
+  uint8_t r = 0;
+  uint8_t db;
+  uint16_t x = 0;
+  uint16_t count = term ? term->count : 0;
+  bool custom = term && term->len;
   bool readWithEoi = false;
   bool eoiDetected = false;
 
-  endByte = endByte;  // meaningless but defeats vcompiler warning!
-
   // Reset transmission break flag
   txBreak = 0;
 
+  startTerminator(term);
+
   // EOI detection required ?
   if (cfg.eoi || detectEoi || (cfg.eor==7)) readWithEoi = true;    // Use EOI as terminator
 
-  // Set up for reading in Controller mode
-  if (cfg.cmode == 2) {   // Controler mode
-    
-    addressDevice(cfg.paddr, 1);
-    // Wait for instrument ready
-    // Set GPIB control lines to controller read mode
-    setControls(CLAS);
-    
-  // Set up for reading in Device mode
-  } else {  // Device mode
-    // Set GPIB controls to device read mode
-    setControls(DLAS);
-    readWithEoi = true;  // In device mode we read with EOI by default
-  }
-  readyGpibDbus();
+  // Address the talker and set the bus up for reading
+  if (startReceive()) readWithEoi = true;  // In device mode we read with EOI by default
 
   // Perform read of data (r=0: data read OK; r>0: GPIB read error);
   while (r == 0) {
@@ -228,7 +276,7 @@ bool GPIBbus::receiveData(Stream& dataStream, bool detectEoi, bool detectEndByte
     if (isAsserted(ATN)) break;
 
     // Read the next character on the GPIB bus
-    r = readByte(&bytes[0], readWithEoi, &eoiDetected);
+    r = readByte(&db, readWithEoi, &eoiDetected);
 
     if (isAsserted(ATN)) r = 2;
 
@@ -237,33 +285,193 @@ bool GPIBbus::receiveData(Stream& dataStream, bool detectEoi, bool detectEndByte
 
     // If successfully received character
     if (r==0) {
-      dataStream.print((char)bytes[0]);
+      bufferByte(dataStream, db);
       x++;
 
+      // Requested number of bytes received?
+      if (count && (x >= count)) break;
+
       // EOI detection enabled and EOI detected?
-      if (readWithEoi) {
-        if (eoiDetected) break;
-      }else{
-        // Has a termination sequence been found ?
-        if (detectEndByte) {
-          if (r == endByte) break;
-        }else{
-          if (isTerminatorDetected(bytes, eor)) break;
-        }
-      }
+      if (readWithEoi && eoiDetected) break;
 
-      // Shift last three bytes in memory
-      bytes[2] = bytes[1];
-      bytes[1] = bytes[0];
+      // Has a termination sequence been found? A sequence given for this
+      // read is also checked when reading with EOI
+      if (isTerminatorDetected(db) && (custom || !readWithEoi)) break;
     }else{
       // Stop (error or timeout)
       break;
     }
   }
 
+  // Send whatever remains in the staging buffer
+  flushBuffer(dataStream);
+
+  // Detected that EOI has been asserted
+  if (eoiDetected && cfg.eot_en) dataStream.print(cfg.eot_ch);
+
+  // Return controller or device to idle state
+  endReceive();
+
+  if (r > 0) return ERR;
+
+  return OK;
+}
+
+/***** Read an IEEE 488.2 definite length block: #<n><len><bytes> *****/
+/*
+ * Bytes preceding the '#' (e.g. a header such as ":WAV:DATA ") are passed through
+ * as text. The header is parsed and exactly <len> bytes are then moved without any
+ * terminator detection, so CR/LF within the binary data does not end the read.
+ * Any trailing bytes (usually LF with EOI) are read in the normal way. An
+ * indefinite length block (#0) is read until EOI.
+ */
+bool GPIBbus::receiveBlock(Stream& dataStream) {
+
+  uint8_t r = 0;
+  uint8_t bytes[1] = {0};
+  uint8_t ndigits = 0;
+  uint32_t blen = 0;
+  bool indefinite = false;
+  bool eoiDetected = false;
+
+  // Reset transmission break flag
+  txBreak = 0;
+
+  startReceive();
+  startTerminator(NULL);
+
+  // Pass through any prefix until the start of the block header
+  while (true) {
+    if (txBreak || isAsserted(ATN)) break;
+    r = readByte(&bytes[0], true, &eoiDetected);
+    if (r) break;
+    bufferByte(dataStream, bytes[0]);
+    if (bytes[0] == '#') break;
+    if (isTerminatorDetected(bytes[0]) || eoiDetected) break;
+  }
+
+  // Header: number of length digits followed by the length digits themselves
+  if (!r && !eoiDetected && bytes[0] == '#') {
+    r = readByte(&bytes[0], true, &eoiDetected);
+    if (!r) {
+      bufferByte(dataStream, bytes[0]);
+      if (bytes[0] >= '0' && bytes[0] <= '9') {
+        ndigits = bytes[0] - '0';
+        indefinite = (ndigits == 0);
+      } else {
+        // Not a valid block header
+        r = 3;
+      }
+    }
+    while (!r && !eoiDetected && ndigits) {
+      r = readByte(&bytes[0], true, &eoiDetected);
+      if (r) break;
+      bufferByte(dataStream, bytes[0]);
+      if (bytes[0] < '0' || bytes[0] > '9') {
+        r = 3;
+        break;
+      }
+      blen = (blen * 10) + (bytes[0] - '0');
+      ndigits--;
+    }
+
+    if (!r && !eoiDetected) {
+      if (indefinite) {
+        // Indefinite length block - data is terminated by EOI
+        while (!eoiDetected) {
+          r = readByte(&bytes[0], true, &eoiDetected);
+          if (r) break;
+          bufferByte(dataStream, bytes[0]);
+        }
+      } else {
+        // Definite length block - move exactly blen bytes
+        while (blen) {
+          r = readByte(&bytes[0], true, &eoiDetected);
+          if (r) break;
+          bufferByte(dataStream, bytes[0]);
+          blen--;
+          if (eoiDetected) break;
+        }
+      }
+    }
+
+    // Trailing terminator following the block
+    startTerminator(NULL);
+    while (!r && !eoiDetected) {
+      if (txBreak || isAsserted(ATN)) break;
+      r = readByte(&bytes[0], true, &eoiDetected);
+      if (r) break;
+      bufferByte(dataStream, bytes[0]);
+      if (isTerminatorDetected(bytes[0])) break;
+    }
+  }
+
+  // Send whatever remains in the staging buffer
+  flushBuffer(dataStream);
+
   // Detected that EOI has been asserted
   if (eoiDetected && cfg.eot_en) dataStream.print(cfg.eot_ch);
 
+  // Return controller or device to idle state
+  endReceive();
+
+  if (r > 0) return ERR;
+
+  return OK;
+}
+
+/***** Stage a received byte, writing out the buffer when it is full *****/
+void GPIBbus::bufferByte(Stream& dataStream, uint8_t db) {
+  stats.rxBytes++;
+  rxBuf[rxLen++] = db;
+  if (rxLen == GPIB_RXBUF_SIZE) flushBuffer(dataStream);
+#ifdef AR_SERIAL_RTS_PIN
+  // Serial input is not read during a transfer - check every 16 bytes that
+  // the host is held off before the input buffer fills
+  else if (!(rxLen & 0x0F)) DATAPORT_FLOW();
+#endif
+}
+
+/***** Write out any bytes held in the staging buffer *****/
+void GPIBbus::flushBuffer(Stream& dataStream) {
+  if (rxLen) dataStream.write(rxBuf, rxLen);
+  rxLen = 0;
+  DATAPORT_FLOW();
+}
+
+/***** Address the talker and set the bus up to receive data *****/
+/*
+ * Returns true in device mode, where reads are always EOI terminated
+ */
+bool GPIBbus::startReceive() {
+  bool deviceMode = false;
+
+  xferStart = micros();
+
+  // Set up for reading in Controller mode
+  if (cfg.cmode == 2) {   // Controler mode
+    
+    addressDevice(cfg.paddr, 1);
+    // Wait for instrument ready
+    // Set GPIB control lines to controller read mode
+    setControls(CLAS);
+    
+  // Set up for reading in Device mode
+  } else {  // Device mode
+    // Set GPIB controls to device read mode
+    setControls(DLAS);
+    deviceMode = true;
+  }
+  readyGpibDbus();
+  rxLen = 0;
+  return deviceMode;
+}
+
+/***** Return the bus to idle once a receive has completed *****/
+void GPIBbus::endReceive() {
+  stats.rxMicros += micros() - xferStart;
+  stats.rxCount++;
+
   // Return controller to idle state
   if (cfg.cmode == 2) {
     // Untalk bus and unlisten controller
@@ -277,19 +485,21 @@ bool GPIBbus::receiveData(Stream& dataStream, bool detectEoi, bool detectEndByte
 
   // Reset break flag
   if (txBreak) txBreak = false;
-  if (r > 0) return ERR;
-
-  return OK;
 }
 
-void GPIBbus::sendData(char *data, uint8_t dsize) {
+void GPIBbus::sendData(char *data, uint16_t dsize) {
 
   bool err = false;
-  char dend = dsize-1;
-  int i;
+  uint16_t dend;
+  uint16_t i;
 
+  // Index of the last byte to be written (including terminators) - carries EOI
+  dend = dsize + (heldPending ? 1 : 0);
   if (!(cfg.eos & 1)) dend++;
   if (!(cfg.eos & 2)) dend++;
+  dend--;
+
+  xferStart = micros();
 
   // Controler can unlisten bus and address devices
   if (cfg.cmode == 2) {
@@ -299,10 +509,18 @@ void GPIBbus::sendData(char *data, uint8_t dsize) {
     setControls(DTAS);
   }
 
+  i = 0;
+
+  // Byte held back from a previous sendDataPart()
+  if (heldPending) {
+    heldPending = false;
+    err = writeByte(heldByte, i == dend);
+    i++;
+  }
+
   // Write the data string
-  for (i = 0; i < dsize; i++) {
-    err = writeByte(data[i], i == dend);
-    if (err) break;
+  for (uint16_t j = 0; (j < dsize) && !err; j++, i++) {
+    err = writeByte(data[j], i == dend);
   }
 
   if (!err) {
@@ -325,6 +543,55 @@ void GPIBbus::sendData(char *data, uint8_t dsize) {
     // Set control lines to idle
     setControls(DIDS);
   }
+
+  stats.txBytes += err ? (i - 1) : i;
+  stats.txMicros += micros() - xferStart;
+  stats.txCount++;
+}
+
+/***** Write part of a longer message *****/
+/*
+ * No terminators are added and the last byte is held back, so that when the
+ * message is completed with sendData() EOI is asserted only on the real final
+ * byte. The listener stays addressed between parts.
+ */
+void GPIBbus::sendDataPart(char *data, uint16_t dsize) {
+
+  bool err = false;
+
+  if (dsize == 0) return;
+
+  xferStart = micros();
+
+  if (cfg.cmode == 2) {
+    setControls(CTAS);
+  } else {
+    setControls(DTAS);
+  }
+
+  // Byte held back from the previous part
+  if (heldPending) {
+    err = writeByte(heldByte, NO_EOI);
+    if (!err) stats.txBytes++;
+  }
+
+  // Write all but the last byte
+  for (uint16_t i = 0; (i < (dsize - 1)) && !err; i++) {
+    err = writeByte(data[i], NO_EOI);
+    if (!err) stats.txBytes++;
+  }
+
+  // Hold on to the last byte, or drop the message on error
+  heldByte = data[dsize - 1];
+  heldPending = !err;
+
+  if (cfg.cmode == 2) {
+    setControls(CIDS);
+  } else {
+    setControls(DIDS);
+  }
+
+  stats.txMicros += micros() - xferStart;
 }
 
 void GPIBbus::signalBreak(){
@@ -403,7 +670,10 @@ void GPIBbus::setControls(uint8_t state) {
     default:
       setGpibState(0b00000110, 0b10111001, 0b11111111);
   }
+  // HS488 is negotiated again whenever the bus changes direction
+  if (state != cstate) hsState = HS488_IDLE;
   cstate = state;
+  TRACE(TR_CTRL, state);
 }
 
 void GPIBbus::setControlVal(uint8_t value, uint8_t mask, uint8_t mode){
@@ -415,6 +685,11 @@ void GPIBbus::setDataVal(uint8_t value){
 }
 
 bool GPIBbus::unAddressDevice() {
+  // Sticky mode: leave the device addressed for the next transfer
+  if (stickyAddr && (addrCache != NO_ADDR_CACHE)) {
+    deviceAddressed = false;
+    return OK;
+  }
   // De-bounce
   delayMicroseconds(30);
   // Utalk/unlisten
@@ -426,7 +701,16 @@ bool GPIBbus::unAddressDevice() {
 }
 
 bool GPIBbus::addressDevice(uint8_t addr, bool talk) {
+  // Sticky mode: the device is still addressed in this direction
+  if (stickyAddr && (addrCache == addr) && (addrCacheTalk == talk)) {
+    deviceAddressed = true;
+    return OK;
+  }
   if (sendCmd(GC_UNL)) return ERR;
+  // Sticky mode: a previous talker may not have been unaddressed
+  if (stickyAddr) {
+    if (sendCmd(GC_UNT)) return ERR;
+  }
   if (talk) {
     // Device to talk, controller to listen
     if (sendCmd(GC_TAD + addr)) return ERR;
@@ -437,6 +721,8 @@ bool GPIBbus::addressDevice(uint8_t addr, bool talk) {
 
   // Set flag
   deviceAddressed = true;
+  addrCache = addr;
+  addrCacheTalk = talk;
   return OK;
 }
 
@@ -444,6 +730,324 @@ bool GPIBbus::haveAddressedDevice(){
   return deviceAddressed;
 }
 
+/***** Enable or disable sticky addressing *****/
+/*
+ * In sticky mode the last talker or listener is left addressed and the
+ * UNL/UNT/TAD/LAD sequence is only sent when the address or direction
+ * changes. Any other command, IFC, a mode change or a handshake error
+ * clears the cache so that the next transfer uses full addressing.
+ */
+void GPIBbus::setStickyAddressing(bool enable) {
+  if (!enable && stickyAddr && (addrCache != NO_ADDR_CACHE)) {
+    // Release the device left addressed by the last transfer
+    stickyAddr = false;
+    if (isController()) {
+      unAddressDevice();
+      setControls(CIDS);
+    }
+  }
+  stickyAddr = enable;
+  addrCache = NO_ADDR_CACHE;
+}
+
+/***** Serial poll primitives *****/
+/*
+ * startSerialPoll() addresses the controller to listen and sends SPE,
+ * serialPoll() then reads the status byte of each device in turn and
+ * endSerialPoll() sends SPD, UNT and UNL and returns to controller idle.
+ */
+bool GPIBbus::startSerialPoll(){
+  // Send Unlisten [UNL] to all devices
+  if (sendCmd(GC_UNL)) return ERR;
+  // Controller addresses itself as listner
+  if (sendCmd(GC_LAD + cfg.caddr)) return ERR;
+  // Send Serial Poll Enable [SPE] to all devices
+  if (sendCmd(GC_SPE)) return ERR;
+  return OK;
+}
+
+uint8_t GPIBbus::serialPoll(uint8_t addr, uint8_t *sb){
+  bool eoiDetected = false;
+  if (sendCmd(GC_TAD + addr)) return 0xFF;
+  // Set GPIB control to controller active listner state (ATN unasserted)
+  setControls(CLAS);
+  // Read the response byte (usually device status) using handshake - suppress EOI detection
+  return readByte(sb, false, &eoiDetected);
+}
+
+bool GPIBbus::endSerialPoll(){
+  // Send Serial Poll Disable [SPD] to all devices
+  if (sendCmd(GC_SPD)) return ERR;
+  // Send Untalk [UNT] to all devices
+  if (sendCmd(GC_UNT)) return ERR;
+  // Unadress listners [UNL] to all devices
+  if (sendCmd(GC_UNL)) return ERR;
+  // Set GPIB control to controller idle state
+  setControls(CIDS);
+  return OK;
+}
+
+/***** Configure the parallel poll response of a device *****/
+/*
+ * ppe is GC_PPE + sense (bit 3) + response line - 1 (bits 0-2), or GC_PPD to
+ * disable the device's response
+ */
+bool GPIBbus::configParallelPoll(uint8_t addr, uint8_t ppe){
+  if (sendCmd(GC_UNL)) return ERR;
+  if (sendCmd(GC_LAD + addr)) return ERR;
+  // Parallel Poll Configure [PPC] followed by the PPE/PPD secondary command
+  if (sendCmd(GC_PPC)) return ERR;
+  if (sendCmd(ppe)) return ERR;
+  if (sendCmd(GC_UNL)) return ERR;
+  deviceAddressed = false;
+  addrCache = NO_ADDR_CACHE;
+  setControls(CIDS);
+  return OK;
+}
+
+/***** Disable the parallel poll response of all devices *****/
+bool GPIBbus::unconfigParallelPoll(){
+  // Parallel Poll Unconfigure [PPU]
+  if (sendCmd(GC_PPU)) return ERR;
+  setControls(CIDS);
+  return OK;
+}
+
+/***** Conduct a parallel poll *****/
+/*
+ * Returns the DIO lines asserted by the devices (DIO1 = bit 0)
+ */
+uint8_t GPIBbus::parallelPoll(){
+  uint8_t sb;
+
+  setControls(CIDS);
+  delayMicroseconds(20);
+  // Assert ATN and EOI (IDY)
+  setControlVal(0b00000000, 0b10010000, 0);
+  delayMicroseconds(20);
+  // Read data byte from GPIB bus without handshake
+  sb = readGpibDbus();
+  // Return to controller idle state (ATN and EOI unasserted)
+  setControls(CIDS);
+  return sb;
+}
+
+/***** Latch SRQ assertions using the external interrupt on the SRQ pin *****/
+/*
+ * Returns false if the SRQ pin has no external interrupt on this board
+ */
+bool GPIBbus::enableSrqInterrupt(){
+  if (digitalPinToInterrupt(SRQ) == NOT_AN_INTERRUPT) return false;
+  srqTail = srqHead;
+  attachInterrupt(digitalPinToInterrupt(SRQ), srqIsr, FALLING);
+  return true;
+}
+
+void GPIBbus::disableSrqInterrupt(){
+  if (digitalPinToInterrupt(SRQ) != NOT_AN_INTERRUPT) detachInterrupt(digitalPinToInterrupt(SRQ));
+  srqTail = srqHead;
+}
+
+/***** Retrieve the time (micros) of the oldest queued SRQ assertion *****/
+bool GPIBbus::getSrqEvent(unsigned long *tstamp){
+  if (srqTail == srqHead) return false;
+  *tstamp = srqTime[srqTail];
+  srqTail = (srqTail + 1) & (GPIB_SRQ_QUEUE_SIZE - 1);
+  return true;
+}
+
+/***** Device mode ATN handling *****/
+/*
+ * Where the ATN pin supports an interrupt, holdAtn() asserts NRFD as soon as
+ * ATN is asserted so that the controller is held off until loop() gets round
+ * to decoding the command bytes, and any handshake in progress is abandoned.
+ * decodeAtn() itself always runs from loop() via getAtnEvent().
+ */
+bool GPIBbus::enableAtnInterrupt(){
+  atnIntr = false;
+  atnHeld = false;
+  if (digitalPinToInterrupt(ATN) == NOT_AN_INTERRUPT) return false;
+  atnBus = this;
+  atnIntr = true;
+  attachInterrupt(digitalPinToInterrupt(ATN), atnIsr, FALLING);
+  return true;
+}
+
+void GPIBbus::disableAtnInterrupt(){
+  if (atnIntr) detachInterrupt(digitalPinToInterrupt(ATN));
+  atnIntr = false;
+  atnHeld = false;
+  atnBus = NULL;
+}
+
+/***** ATN interrupt: assert NRFD (not ready for data) and flag the command phase *****/
+/*
+ * The main line port updates of setGpibState() are made with interrupts
+ * disabled (see AR488_Board.h), so this cannot be lost to, or undo, one of them.
+ * The Arduino pin functions used by other boards are atomic on AVR.
+ */
+void GPIBbus::holdAtn(){
+  setGpibState(0b00000000, 0b00000100, 0);
+  setGpibState(0b00000100, 0b00000100, 1);
+  atnHeld = true;
+}
+
+/***** Lean decoder for the command bytes sent while ATN is asserted *****/
+/*
+ * Tracks the addressed and serial poll state in devState and answers a serial
+ * poll as soon as ATN is released. SDC and secondary addresses are flagged for
+ * loop() to act on. If the controller stalls, the handshake lines are left
+ * asserted and decoding carries on at the next call while ATN is still
+ * asserted, so no command byte of the phase is missed. A byte whose handshake
+ * timed out after it was taken is decoded again, which is harmless as each
+ * command only sets state.
+ */
+void GPIBbus::decodeAtn(){
+  uint8_t state = devState;
+  uint8_t db;
+  uint8_t r;
+
+  if (!isAsserted(ATN)) return;
+
+  // Assert NRFD and NDAC to hold off the controller until we are ready
+  setControls(DLAS);
+
+  while ((r = readCmdByte(&db)) == 0) {
+    TRACE(TR_ATN, db);
+    if (db == GC_UNL) {
+      state &= ~DEV_LISTEN;
+    } else if (db == GC_UNT) {
+      state &= ~DEV_TALK;
+    } else if (db == (GC_LAD + cfg.paddr)) {      // MLA
+      state = (state | DEV_LISTEN) & ~DEV_TALK;
+    } else if (db == (GC_TAD + cfg.paddr)) {      // MTA
+      state = (state | DEV_TALK) & ~DEV_LISTEN;
+    } else if ((db & 0xE0) == GC_TAD) {           // Other talk address
+      state &= ~DEV_TALK;
+    } else if ((db & 0xE0) == 0x60) {             // Secondary address
+      if (state & (DEV_LISTEN | DEV_TALK)) {
+        atnSaddr = db;
+        state |= DEV_SADDR;
+      }
+    } else if (db == GC_SPE) {
+      state |= DEV_SPOLL;
+    } else if (db == GC_SPD) {
+      state &= ~DEV_SPOLL;
+    } else if ((db == GC_SDC) && (state & DEV_LISTEN)) {
+      state |= DEV_SDC;
+    }
+  }
+
+  // Timed out with ATN still asserted: keep holding off the controller
+  if ((r != 2) && isAsserted(ATN)) {
+    devState = state & ~DEV_ATN;
+    return;
+  }
+
+  if ((state & DEV_TALK) && (state & DEV_SPOLL) && !isAsserted(ATN)) {
+    // Serial poll - send the status byte straight away
+    setControls(DTAS);
+    if (writeStatusByte(cfg.stat) == 0) {
+      // Clear the SRQ bit and de-assert the SRQ signal
+      cfg.stat = cfg.stat & ~0x40;
+      clrSrqSig();
+    }
+    setControls(DIDS);
+  } else if (!(state & DEV_LISTEN)) {
+    setControls(DIDS);
+  }
+
+  devState = state | DEV_ATN;
+  atnHeld = false;
+}
+
+/***** Return the state decoded from the last command phase, if any *****/
+uint8_t GPIBbus::getAtnEvent(uint8_t *saddr){
+  uint8_t state;
+
+  if (isAsserted(ATN)) {
+    decodeAtn();
+  } else if (atnHeld) {
+    // ATN was released before it was decoded: restore the handshake lines
+    atnHeld = false;
+    setControls(cstate);
+  }
+
+  noInterrupts();
+  state = devState;
+  *saddr = atnSaddr;
+  devState = state & ~(DEV_ATN | DEV_SDC | DEV_SADDR);
+  interrupts();
+
+  return (state & DEV_ATN) ? state : 0;
+}
+
+/***** Command byte handshake used by decodeAtn() *****/
+/*
+ * Only ATN is checked and each wait is bounded by a spin count so that loop()
+ * is not held up by a stalled controller.
+ * Returns 0 on success, 2 when ATN is released and 6 or 8 on timeout.
+ */
+uint8_t GPIBbus::readCmdByte(uint8_t *db) {
+  uint16_t spin = 0;
+
+  // Unassert NRFD (we are ready for more data)
+  setGpibState(0b00000100, 0b00000100, 0);
+
+  // Wait for DAV to go LOW while ATN remains asserted
+  while (getGpibHsLines() & HS_DAV) {
+    if (!isAsserted(ATN)) return 2;
+    if (!++spin) return 6;
+  }
+
+  // Assert NRFD (Busy reading data)
+  setGpibState(0b00000000, 0b00000100, 0);
+  // read from DIO
+  *db = readGpibDbus();
+  // Unassert NDAC signalling data accepted
+  setGpibState(0b00000010, 0b00000010, 0);
+
+  // Wait for DAV to go HIGH indicating data no longer valid
+  while (!(getGpibHsLines() & HS_DAV)) {
+    if (!++spin) return 8;
+  }
+
+  // Re-assert NDAC - handshake complete, ready to accept data again
+  setGpibState(0b00000000, 0b00000010, 0);
+  return 0;
+}
+
+/***** Status byte handshake used by decodeAtn() *****/
+/*
+ * Returns 0 on success, 2 if ATN is asserted and 4-8 on timeout.
+ */
+uint8_t GPIBbus::writeStatusByte(uint8_t db) {
+  uint16_t spin = 0;
+
+  // Wait for NDAC to go LOW and NRFD to go HIGH (listener ready)
+  while (getGpibHsLines() & HS_NDAC) {
+    if (!++spin) return 4;
+  }
+  while (!(getGpibHsLines() & HS_NRFD)) {
+    if (isAsserted(ATN)) return 2;
+    if (!++spin) return 5;
+  }
+
+  // Place data on the bus and assert DAV
+  setGpibDbus(db);
+  setGpibState(0b00000000, 0b00001000, 0);
+
+  // Wait for the listener to accept the data (NDAC goes HIGH)
+  while (!(getGpibHsLines() & HS_NDAC)) {
+    if (!++spin) return 7;
+  }
+
+  // Unassert DAV and release the data bus
+  setGpibState(0b00001000, 0b00001000, 0);
+  readyGpibDbus();
+  return 0;
+}
+
 bool GPIBbus::isDeviceAddressedToListen(){
   if (cstate == DLAS) return true;
   return false;
@@ -464,6 +1068,23 @@ void GPIBbus::clearDataBus(){
 }
 
 uint8_t GPIBbus::readByte(uint8_t *db, bool readWithEoi, bool *eoi) {
+  uint8_t stage;
+
+  if (fastHs) {
+    stage = readByteFast(db, readWithEoi, eoi);
+  } else {
+    stage = readByteStaged(db, readWithEoi, eoi);
+  }
+  if (stage) {
+    countAbort(stage, stats.rdTmo);
+    TRACE(TR_RDABT, stage);
+  } else {
+    TRACE(*eoi ? TR_RDEOI : TR_RD, *db);
+  }
+  return stage;
+}
+
+uint8_t GPIBbus::readByteStaged(uint8_t *db, bool readWithEoi, bool *eoi) {
 
   unsigned long startMillis = millis();
   unsigned long currentMillis = startMillis + 1;
@@ -488,6 +1109,12 @@ uint8_t GPIBbus::readByte(uint8_t *db, bool readWithEoi, bool *eoi) {
         stage = 2;
         break;
       }
+
+      // ATN has been asserted and is held for decodeAtn()
+      if (atnHeld) {
+        stage = 2;
+        break;
+      }
     }
 
     if (stage == 4) {
@@ -534,7 +1161,47 @@ uint8_t GPIBbus::readByte(uint8_t *db, bool readWithEoi, bool *eoi) {
   return stage;
 }
 
-uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte) {
+uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte, bool withEoi) {
+  uint8_t stage;
+
+  if (hs488 && ((cstate == CTAS) || (cstate == DTAS))) {
+    stage = writeByteHs(db, isLastByte, withEoi);
+  } else if (fastHs) {
+    stage = writeByteFast(db, withEoi);
+  } else {
+    stage = writeByteStaged(db, withEoi);
+  }
+  if (stage) {
+    countAbort(stage, stats.wrTmo);
+    TRACE(TR_WRABT, stage);
+  } else {
+    TRACE((cstate == CCMS) ? TR_CMD : (withEoi ? TR_WREOI : TR_WR), db);
+  }
+  return stage;
+}
+
+/***** Count a handshake that did not complete *****/
+/*
+ * stage 1=IFC, 2=ATN, 4-8 timeout at that handshake stage
+ */
+void GPIBbus::countAbort(uint8_t stage, uint16_t tmo[5]) {
+  // Addressed state is unknown after an error
+  addrCache = NO_ADDR_CACHE;
+  hsState = HS488_IDLE;
+  if (stage == 1) {
+    stats.ifcAborts++;
+  } else if (stage == 2) {
+    stats.atnAborts++;
+  } else if ((stage >= 4) && (stage <= 8)) {
+    tmo[stage - 4]++;
+  }
+}
+
+void GPIBbus::clearStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t GPIBbus::writeByteStaged(uint8_t db, bool withEoi) {
   unsigned long startMillis = millis();
   unsigned long currentMillis = startMillis + 1;
   const unsigned long timeval = cfg.rtmo;
@@ -557,6 +1224,12 @@ uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte) {
         stage = 2;
         break;
       }
+
+      // ATN has been asserted and is held for decodeAtn()
+      if (atnHeld) {
+        stage = 2;
+        break;
+      }
     }
 
     // Wait for NDAC to go LOW (indicating that devices (stage==4) || (stage==8) ) are at attention)
@@ -572,7 +1245,7 @@ uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte) {
     if (stage == 6){
       // Place data on the bus
       setGpibDbus(db);
-      if (cfg.eoi && isLastByte) {
+      if (withEoi) {
         // If EOI enabled and this is the last byte then assert DAV and EOI
         setGpibState(0b00000000, 0b00011000, 0);
       }else{
@@ -601,7 +1274,7 @@ uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte) {
 
   // Handshake complete
   if (stage == 9) {
-    if (cfg.eoi && isLastByte) {
+    if (withEoi) {
       // If EOI enabled and this is the last byte then un-assert both DAV and EOI
       setGpibState(0b00011000, 0b00011000, 0);
     }else{
@@ -617,42 +1290,274 @@ uint8_t GPIBbus::writeByte(uint8_t db, bool isLastByte) {
   return stage;
 }
 
-bool GPIBbus::isTerminatorDetected(uint8_t bytes[3], uint8_t eorSequence){
-  // Look for specified terminator (CR+LF by default)
-  switch (eorSequence) {
-    case 0:
-        // CR+LF terminator
-        if (bytes[0]==LF && bytes[1]==CR) return true;
-        break;
+/***** Fast handshake *****/
+/*
+ * Each handshake edge is waited for in a tight loop reading the handshake lines
+ * directly. The timeout and, in device mode, IFC/ATN are only checked once every
+ * 256 passes (see hsAbort()) rather than on every pass.
+ */
+uint8_t GPIBbus::readByteFast(uint8_t *db, bool readWithEoi, bool *eoi) {
+
+  const unsigned long startMillis = millis();
+  const bool atnStat = isAsserted(ATN); // Capture state of ATN
+  uint8_t spin = 0;
+  uint8_t stage;
+
+  *eoi = false;
+
+  // Unassert NRFD (we are ready for more data)
+  setGpibState(0b00000100, 0b00000100, 0);
+
+  // Wait for DAV to go LOW indicating talker has finished setting data lines..
+  while (getGpibHsLines() & HS_DAV) {
+    if (!++spin && (stage = hsAbort(6, startMillis, atnStat, false))) return stage;
+  }
+
+  // Assert NRFD (Busy reading data)
+  setGpibState(0b00000000, 0b00000100, 0);
+  // Check for EOI signal
+  if (readWithEoi && !(getGpibHsLines() & HS_EOI)) *eoi = true;
+  // read from DIO
+  *db = readGpibDbus();
+  // Unassert NDAC signalling data accepted
+  setGpibState(0b00000010, 0b00000010, 0);
+
+  // Wait for DAV to go HIGH indicating data no longer valid (i.e. transfer complete)
+  while (!(getGpibHsLines() & HS_DAV)) {
+    if (!++spin && (stage = hsAbort(8, startMillis, atnStat, false))) return stage;
+  }
+
+  // Re-assert NDAC - handshake complete, ready to accept data again
+  setGpibState(0b00000000, 0b00000010, 0);
+  return 0;
+}
+
+uint8_t GPIBbus::writeByteFast(uint8_t db, bool withEoi) {
+
+  const unsigned long startMillis = millis();
+  uint8_t spin = 0;
+  uint8_t stage;
+
+  // Wait for NDAC to go LOW (indicating that devices are at attention)
+  while (getGpibHsLines() & HS_NDAC) {
+    if (!++spin && (stage = hsAbort(4, startMillis, false, true))) return stage;
+  }
+
+  // Wait for NRFD to go HIGH (indicating that receiver is ready)
+  while (!(getGpibHsLines() & HS_NRFD)) {
+    if (!++spin && (stage = hsAbort(5, startMillis, false, true))) return stage;
+  }
+
+  // Place data on the bus
+  setGpibDbus(db);
+  // Assert DAV (data is valid - ready to collect), with EOI on the last byte
+  setGpibState(0b00000000, withEoi ? 0b00011000 : 0b00001000, 0);
+
+  // Wait for NRFD to go LOW (receiver accepting data)
+  while (getGpibHsLines() & HS_NRFD) {
+    if (!++spin && (stage = hsAbort(7, startMillis, false, true))) return stage;
+  }
+
+  // Wait for NDAC to go HIGH (data accepted)
+  while (!(getGpibHsLines() & HS_NDAC)) {
+    if (!++spin && (stage = hsAbort(8, startMillis, false, true))) return stage;
+  }
+
+  // Unassert DAV (and EOI)
+  setGpibState(0b00011000, withEoi ? 0b00011000 : 0b00001000, 0);
+  // Reset the data bus
+  setGpibDbus(0);
+  return 0;
+}
+
+/***** HS488 handshake *****/
+/*
+ * An outline of the talker side of the IEEE 488.1-2003 HS488 extension,
+ * enabled with ++hs488. Each message starts with a 3-wire byte. An HS488
+ * listener accepts it with a short NDAC pulse while DAV is still asserted,
+ * which a 3-wire listener never does (it holds NDAC high until DAV is
+ * released). Once the talker has seen the pulse the following bytes are sent
+ * without waiting for NDAC: the talker waits for NRFD, puts the byte on the
+ * bus, waits T1 and pulses DAV. The listener holds NRFD asserted while it is
+ * busy, which is the only flow control. The last byte of a message is always
+ * sent 3-wire so that the talker knows it was accepted. If there is no pulse
+ * the rest of the message uses the 3-wire handshake. A 3-wire listener
+ * addressed together with an HS488 one cannot be detected, so HS488 is only
+ * for a single listener.
+ *
+ * Data is always received with the 3-wire handshake. Offering HS488 as a
+ * listener needs the NDAC pulse to be seen by the talker, which a 3-wire
+ * talker that polls NDAC can miss, and which a second listener hides.
+ */
+uint8_t GPIBbus::writeByteHs(uint8_t db, bool isLastByte, bool withEoi) {
+
+  const unsigned long startMillis = millis();
+  uint8_t spin = 0;
+  uint8_t stage;
+  uint8_t t;
+
+  if ((hsState == HS488_ACTIVE) && !isLastByte) {
+    // Wait for NRFD to go HIGH (indicating that receiver is ready)
+    while (!(getGpibHsLines() & HS_NRFD)) {
+      if (!++spin && (stage = hsAbort(5, startMillis, false, true))) return stage;
+    }
+    // Place data on the bus and let it settle before asserting DAV
+    setGpibDbus(db);
+    delayMicroseconds(HS488_T1_US);
+    setGpibState(0b00000000, 0b00001000, 0);
+    // Hold DAV until the listener asserts NRFD or the hold time has expired
+    t = HS488_HOLD_US;
+    while ((getGpibHsLines() & HS_NRFD) && t) {
+      t--;
+      delayMicroseconds(1);
+    }
+    // Unassert DAV
+    setGpibState(0b00001000, 0b00001000, 0);
+    return 0;
+  }
+
+  if ((hsState != HS488_IDLE) || isLastByte) {
+    stage = writeByteFast(db, withEoi);
+    if (isLastByte) hsState = HS488_IDLE;
+    return stage;
+  }
+
+  // First byte of a message: 3-wire, watching for the listener's NDAC pulse
+
+  // Wait for NDAC to go LOW (indicating that devices are at attention)
+  while (getGpibHsLines() & HS_NDAC) {
+    if (!++spin && (stage = hsAbort(4, startMillis, false, true))) return stage;
+  }
+
+  // Wait for NRFD to go HIGH (indicating that receiver is ready)
+  while (!(getGpibHsLines() & HS_NRFD)) {
+    if (!++spin && (stage = hsAbort(5, startMillis, false, true))) return stage;
+  }
+
+  // Place data on the bus and assert DAV
+  setGpibDbus(db);
+  setGpibState(0b00000000, 0b00001000, 0);
+
+  // Wait for NRFD to go LOW (receiver accepting data)
+  while (getGpibHsLines() & HS_NRFD) {
+    if (!++spin && (stage = hsAbort(7, startMillis, false, true))) return stage;
+  }
+
+  // Wait for NDAC to go HIGH (data accepted)
+  while (!(getGpibHsLines() & HS_NDAC)) {
+    if (!++spin && (stage = hsAbort(8, startMillis, false, true))) return stage;
+  }
+
+  // An HS488 listener re-asserts NDAC while DAV is still held
+  t = HS488_WINDOW_US;
+  while ((getGpibHsLines() & HS_NDAC) && t) {
+    t--;
+    delayMicroseconds(1);
+  }
+  hsState = (getGpibHsLines() & HS_NDAC) ? HS488_REFUSED : HS488_ACTIVE;
+  TRACE(TR_HS, hsState);
+
+  // Unassert DAV
+  setGpibState(0b00001000, 0b00001000, 0);
+  return 0;
+}
+
+/***** Periodic checks while waiting on a handshake edge *****/
+/*
+ * Returns 0 to keep waiting, 1 if IFC was asserted, 2 on ATN change (device
+ * mode only) or the current stage if the timeout has expired
+ */
+uint8_t GPIBbus::hsAbort(uint8_t stage, unsigned long startMillis, bool atnStat, bool writing) {
+  if (cfg.cmode == 1) {
+    // ATN has been asserted and is held for decodeAtn()
+    if (atnHeld) return 2;
+    // If IFC has been asserted then abort
+    if (isAsserted(IFC)) {
+      if (writing) setControls(DLAS);
+      return 1;
+    }
+    if (writing) {
+      // If ATN has been asserted we need to abort and listen
+      if (isAsserted(ATN)) {
+        setControls(DLAS);
+        return 2;
+      }
+    } else {
+      // ATN unasserted during handshake - not ready yet so abort (and exit ATN loop)
+      if (atnStat && !isAsserted(ATN)) return 2;
+    }
+  }
+  if ((unsigned long)(millis() - startMillis) >= (unsigned long)cfg.rtmo) return stage;
+  return 0;
+}
+
+/***** Set up the terminator for a read *****/
+/*
+ * Uses the sequence given in term if there is one, otherwise the sequence
+ * selected with ++eor.
+ */
+void GPIBbus::startTerminator(readTerm *term) {
+  termPos = 0;
+  termCnt = 0;
+  if (term && term->len) {
+    termLen = (term->len < TERM_MAX) ? term->len : TERM_MAX;
+    memcpy(termSeq, term->seq, termLen);
+    return;
+  }
+  termLen = 0;
+  switch (cfg.eor & 7) {
     case 1:
-        // CR only as terminator
-        if (bytes[0]==CR) return true;
-        break;
+      // CR only as terminator
+      termSeq[termLen++] = CR;
+      break;
     case 2:
-        // LF only as terminator
-        if (bytes[0]==LF) return true;
-        break;
+      // LF only as terminator
+      termSeq[termLen++] = LF;
+      break;
     case 3:
-        // No terminator (will rely on timeout)
-        break;
+      // No terminator (will rely on timeout)
+      break;
     case 4:
-        // Keithley can use LF+CR instead of CR+LF
-        if (bytes[0]==CR && bytes[1]==LF) return true;
-        break;
+      // Keithley can use LF+CR instead of CR+LF
+      termSeq[termLen++] = LF;
+      termSeq[termLen++] = CR;
+      break;
     case 5:
-        // Solarton (possibly others) can also use ETX (0x03)
-        if (bytes[0]==0x03) return true;
-        break;
+      // Solarton (possibly others) can also use ETX (0x03)
+      termSeq[termLen++] = 0x03;
+      break;
     case 6:
-        // Solarton (possibly others) can also use CR+LF+ETX (0x03)
-        if (bytes[0]==0x03 && bytes[1]==LF && bytes[2]==CR) return true;
-        break;
+      // Solarton (possibly others) can also use CR+LF+ETX (0x03)
+      termSeq[termLen++] = CR;
+      termSeq[termLen++] = LF;
+      termSeq[termLen++] = 0x03;
+      break;
+    case 7:
+      // EOI only
+      break;
     default:
-        // Use CR+LF terminator by default
-        if (bytes[0]==LF && bytes[1]==CR) return true;
-        break;
+      // Use CR+LF terminator by default
+      termSeq[termLen++] = CR;
+      termSeq[termLen++] = LF;
+      break;
   }
-  return false;
+}
+
+/***** Add a received byte and check whether the terminator has been received *****/
+/*
+ * The last byte of the sequence is checked first so most bytes are rejected
+ * with a single comparison.
+ */
+bool GPIBbus::isTerminatorDetected(uint8_t db) {
+  termHist[termPos++ & (TERM_MAX - 1)] = db;
+  if (termCnt < 255) termCnt++;
+
+  if ((termLen == 0) || (termCnt < termLen)) return false;
+  if (db != termSeq[termLen - 1]) return false;
+  for (uint8_t i=2; i<=termLen; i++) {
+    if (termHist[(uint8_t)(termPos - i) & (TERM_MAX - 1)] != termSeq[termLen - i]) return false;
+  }
+  return true;
 }
 
 void GPIBbus::setSrqSig() {
@@ -7,6 +7,41 @@
 
 #define GPIB_CFG_SIZE 83
 
+// rxLen is a uint8_t
+static_assert((GPIB_RXBUF_SIZE > 0) && (GPIB_RXBUF_SIZE <= 255), "GPIB_RXBUF_SIZE must be between 1 and 255 (see AR488_Config.h)");
+
+/***** SRQ event queue (power of 2) *****/
+#define GPIB_SRQ_QUEUE_SIZE 8
+
+/***** Device state decoded from command bytes received under ATN *****/
+#define DEV_LISTEN  0x01  // Addressed to listen (MLA)
+#define DEV_TALK    0x02  // Addressed to talk (MTA)
+#define DEV_SPOLL   0x04  // Serial poll enabled (SPE)
+#define DEV_SDC     0x08  // Selected device clear received while addressed to listen
+#define DEV_SADDR   0x10  // Secondary address received while addressed
+#define DEV_ATN     0x80  // A command phase has been decoded
+
+/***** HS488 negotiation state (see writeByteHs()) *****/
+#define HS488_IDLE    0   // Not negotiated yet for this message
+#define HS488_ACTIVE  1   // Other end is HS488 capable
+#define HS488_REFUSED 2   // Other end is 3-wire only for the rest of this message
+
+/***** Read terminator *****/
+/*
+ * A terminator sequence of up to TERM_MAX bytes, and/or a byte count, to end
+ * a read with. When no sequence is given the ++eor setting is used.
+ */
+#define TERM_MAX 8    // Longest terminator sequence (power of 2)
+
+struct readTerm {
+  uint8_t seq[TERM_MAX];  // Terminator sequence
+  uint8_t len;            // Length of the sequence (0 = use ++eor)
+  uint16_t count;         // Stop after this many bytes (0 = no limit)
+};
+
+/***** Sticky addressing - no device is known to be addressed *****/
+#define NO_ADDR_CACHE 0xFF
+
 /***** Debug Port *****/
 #ifdef DB_SERIAL_ENABLE
   extern Stream& debugStream;
@@ -79,8 +114,27 @@ class GPIBbus {
       uint8_t db[GPIB_CFG_SIZE];
     };
 
+    /***** Transfer statistics (++stats) *****/
+    struct GPIBstats {
+      uint32_t rxBytes;     // Data bytes received by receiveData()/receiveBlock()
+      uint32_t rxMicros;    // Time spent receiving data
+      uint32_t txBytes;     // Data bytes written by sendData()/sendDataPart()
+      uint32_t txMicros;    // Time spent sending data
+      uint16_t rxCount;     // Number of receive transfers
+      uint16_t txCount;     // Number of send transfers (complete messages)
+      uint16_t rdTmo[5];    // readByte() timeouts at handshake stage 4-8
+      uint16_t wrTmo[5];    // writeByte() timeouts at handshake stage 4-8
+      uint16_t ifcAborts;   // Handshakes aborted by IFC
+      uint16_t atnAborts;   // Handshakes aborted by ATN
+      uint16_t overflows;   // Serial input buffer overflows
+    };
+
     union GPIBconf cfg;
+    struct GPIBstats stats;
     bool txBreak;  // Signal to break the GPIB transmission
+    bool fastHs;   // Use the tight loop handshake in readByte()/writeByte()
+    bool hs488;    // Offer the HS488 non-interlocked handshake for data bytes sent
+    bool stickyAddr; // Leave the device addressed between transfers
     uint8_t cstate = 0;
 
     GPIBbus();
@@ -98,6 +152,7 @@ class GPIBbus {
     bool sendLLO();
     bool sendGTL();
     bool sendGET(uint8_t addr);
+    bool sendGroupGET(uint8_t *addrs, uint8_t cnt);
     bool sendSDC();
     void sendAllClear();
 
@@ -114,10 +169,15 @@ class GPIBbus {
     void setStatus(uint8_t statusByte);
     bool sendCmd(uint8_t cmdByte);
     uint8_t readByte(uint8_t *db, bool readWithEoi, bool *eoi);
-    uint8_t writeByte(uint8_t db, bool isLastByte);
-    bool receiveData(Stream& dataStream, bool detectEoi, bool detectEndByte, uint8_t endByte);
-    void sendData(char *data, uint8_t dsize);
+    uint8_t writeByte(uint8_t db, bool isLastByte, bool withEoi);
+    // EOI on the last byte when enabled with ++eoi
+    uint8_t writeByte(uint8_t db, bool isLastByte) { return writeByte(db, isLastByte, cfg.eoi && isLastByte); }
+    bool receiveData(Stream& dataStream, bool detectEoi, readTerm *term = NULL);
+    bool receiveBlock(Stream& dataStream);
+    void sendData(char *data, uint16_t dsize);
+    void sendDataPart(char *data, uint16_t dsize);
     void clearDataBus();
+    void clearStats();
     void setControlVal(uint8_t value, uint8_t mask, uint8_t mode);
     void setDataVal(uint8_t);
 
@@ -130,10 +190,60 @@ class GPIBbus {
     bool addressDevice(uint8_t addr, bool dir);
     bool unAddressDevice();
     bool haveAddressedDevice();
+    void setStickyAddressing(bool enable);
+
+    bool startSerialPoll();
+    uint8_t serialPoll(uint8_t addr, uint8_t *sb);
+    bool endSerialPoll();
+
+    bool configParallelPoll(uint8_t addr, uint8_t ppe);
+    bool unconfigParallelPoll();
+    uint8_t parallelPoll();
+
+    bool enableSrqInterrupt();
+    void disableSrqInterrupt();
+    bool getSrqEvent(unsigned long *tstamp);
+
+    bool enableAtnInterrupt();
+    void disableAtnInterrupt();
+    void holdAtn();
+    void decodeAtn();
+    uint8_t getAtnEvent(uint8_t *saddr);
 
   private:
     bool deviceAddressed;
-    bool isTerminatorDetected(uint8_t bytes[3], uint8_t eorSequence);
+    uint8_t addrCache;      // Address left addressed in sticky mode (NO_ADDR_CACHE = unknown)
+    bool addrCacheTalk;     // Direction of the cached address
+    uint8_t termSeq[TERM_MAX];  // Terminator sequence for the current read
+    uint8_t termLen;
+    uint8_t termHist[TERM_MAX]; // Most recent bytes received (ring)
+    uint8_t termPos;            // Next position in termHist
+    uint8_t termCnt;            // Bytes received into termHist (max 255)
+    void startTerminator(readTerm *term);
+    bool isTerminatorDetected(uint8_t db);
+    bool startReceive();
+    void endReceive();
+    uint8_t heldByte;
+    bool heldPending;
+    uint8_t rxBuf[GPIB_RXBUF_SIZE];
+    uint8_t rxLen;
+    void bufferByte(Stream& dataStream, uint8_t db);
+    void flushBuffer(Stream& dataStream);
+    unsigned long xferStart;
+    uint8_t readByteStaged(uint8_t *db, bool readWithEoi, bool *eoi);
+    uint8_t writeByteStaged(uint8_t db, bool withEoi);
+    void countAbort(uint8_t stage, uint16_t tmo[5]);
+    uint8_t readByteFast(uint8_t *db, bool readWithEoi, bool *eoi);
+    uint8_t writeByteFast(uint8_t db, bool withEoi);
+    uint8_t hsAbort(uint8_t stage, unsigned long startMillis, bool atnStat, bool writing);
+    uint8_t hsState;            // HS488_xxx
+    uint8_t writeByteHs(uint8_t db, bool isLastByte, bool withEoi);
+    volatile uint8_t devState;  // DEV_xxx flags maintained by decodeAtn()
+    volatile uint8_t atnSaddr;  // Last secondary address received
+    bool atnIntr;               // The ATN interrupt is attached
+    volatile bool atnHeld;      // NRFD asserted by the ATN interrupt, not decoded yet
+    uint8_t readCmdByte(uint8_t *db);
+    uint8_t writeStatusByte(uint8_t db);
     void setSrqSig();
     void clrSrqSig();
 };
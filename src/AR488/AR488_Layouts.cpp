@@ -3,110 +3,48 @@
 #include "AR488_Config.h"
 #include "AR488_Layouts.h"
 
-#ifdef AR488_MEGA32U4_MICRO
+// The simulated bus (AR488_SimBus.cpp) provides these functions instead
+#ifndef AR488_SIMBUS
+
+#ifdef AR488_BOARD_REGS
+
+/*
+ * Register level pin access generated from the board descriptor (see
+ * AR488_Board.h). getGpibHsLines() is inline in AR488_Layouts.h.
+ */
 
 /***** Set the GPIB data bus to input pullup *****/
 void readyGpibDbus() {
-  // Set data pins to input
-  DDRB  &= 0b10000001 ;
-  DDRD  &= 0b01111110 ;
-  PORTB |= 0b01111110; // PORTB bits 6,5,4,3,2,1 input_pullup
-  PORTD |= 0b10000001; // PORTD bits 7,0 input_pullup
+  BoardPorts::readyDbus();
 }
 
+
 /***** Read the GPIB data bus wires to collect the byte of data *****/
 uint8_t readGpibDbus() {
-  return ~((PIND & 0b10000001) | (PINB & 0b01111110)) ;
+  // GPIB states are inverted
+  return ~BoardPorts::readDbus();
 }
 
+
 /***** Set the GPIB data bus to output and with the requested byte *****/
 void setGpibDbus(uint8_t db) {
-  // Set data pins as outputs
-  DDRB |= 0b01111110;
-  DDRD |= 0b10000001;
-
   // GPIB states are inverted
-  db = ~db;
-
-  // Set data bus
-  PORTB = (PORTB & ~0b01111110) | (db & 0b01111110) ;
-  PORTD = (PORTD & ~0b10000001) | (db & 0b10000001);
+  BoardPorts::setDbus(~db);
 }
 
 
-/***** Set the direction and state of the GPIB control lines *****/
+/***** Set the direction and state of the GPIB control lines ****/
 /*
- * Bits control lines as follows: 7-ATN, 6-SRQ, 5-REN, 4-EOI, 3-DAV, 2-NRFD, 1-NDAC, 0-IFC
-    bits (databits) : State - 0=LOW, 1=HIGH/INPUT_PULLUP; Direction - 0=input, 1=output;
-    mask (mask)     : 0=unaffected, 1=enabled
-    mode (mode)     : 0=set pin state, 1=set pin direction
- * Arduino Pro Micro pin to Port/bit to direction/state byte map:
- * IFC   4   PORTD bit 4   byte bit 0
- * NDAC  A3  PORTF bit 4   byte bit 1
- * NRFD  A2  PORTF bit 5   byte bit 2
- * DAV   A1  PORTF bit 6   byte bit 3
- * EOI   A0  PORTF bit 7   byte bit 4
- * REN   5   PORTC bit 6   byte bit 5
- * SRQ   7   PORTE bit 6   byte bit 6
- * ATN   2   PORTD bit 1   byte bit 7
- * 
- * It would be more efficient (and easier to read the code) if the bits in the above
- * control word were assigned by name to match suitable port bits : then NDAC,NRFD and DAV
- * could be positioned at bits 4,5,6 to be placed in port F without shifting.
- */
+   Bits control lines as follows: 7-ATN, 6-SRQ, 5-REN, 4-EOI, 3-DAV, 2-NRFD, 1-NDAC, 0-IFC
+   state: 0=LOW; 1=HIGH/INPUT_PULLUP
+   dir  : 0=input; 1=output;
+   mode:  0=set pin state; 1=set pin direction
+*/
 void setGpibState(uint8_t bits, uint8_t mask, uint8_t mode) {
-  if (mask & 0b00011110) {
-
-    // PORTF - NDAC, NRFD, DAV and EOI bits 1-4 rotated into bits 4-7
-    uint8_t portFb = (bits & 0x1e) << 3;
-    uint8_t portFm = (mask & 0x1e) << 3;
-
-    // Set registers: register = (register & ~bitmask) | (value & bitmask)
-    // Mask: 0=unaffected; 1=to be changed
-
-    switch (mode) {
-      case 0:
-        // Set pin states using mask
-        PORTF = ( (PORTF & ~portFm) | (portFb & portFm) );
-        break;
-      case 1:
-        // Set pin direction registers using mask
-        DDRF = ( (DDRF & ~portFm) | (portFb & portFm) );
-        break;
-    }
-  }
-
-  if (mask & 0b11100001) {
-    // PORTC - REN bit 5 rotated into bit 6
-    uint8_t portCb = (bits & 0x20) << 1;
-    uint8_t portCm = (mask & 0x20) << 1;
-    // PORTD - IFC bit 0 rotated into bit 4 and ATN bit 7 rotated into 1
-    uint8_t portDb = ((bits & 0x01) << 4) | ((bits & 0x80) >> 6);
-    uint8_t portDm = ((mask & 0x01) << 4) | ((mask & 0x80) >> 6);
-    // PORT E - SRQ bit 6  in bit 6
-    uint8_t portEb = (bits & 0x40);
-    uint8_t portEm = (mask & 0x40);
-
-    // Set registers: register = (register & ~bitmask) | (value & bitmask)
-    // Mask: 0=unaffected; 1=to be changed
-    switch (mode) {
-      case 0:
-        // Set pin states using mask
-        PORTC = ( (PORTC & ~portCm) | (portCb & portCm) );
-        PORTD = ( (PORTD & ~portDm) | (portDb & portDm) );
-        PORTE = ( (PORTE & ~portEm) | (portEb & portEm) );
-        break;
-      case 1:
-        // Set pin direction registers using mask
-        DDRC = ( (DDRC & ~portCm) | (portCb & portCm) );
-        DDRD = ( (DDRD & ~portDm) | (portDb & portDm) );
-        DDRE = ( (DDRE & ~portEm) | (portEb & portEm) );
-        break;
-    }
-  }
+  BoardPorts::setCtrl(bits, mask, mode);
 }
-#else  // AR488_MEGA32U4_MICRO
-#ifdef AR488_CUSTOM
+
+#elif defined(AR488_CUSTOM)  // Other MCU - use Arduino pin functions
 
 uint8_t databus[8] = { DIO1, DIO2, DIO3, DIO4, DIO5, DIO6, DIO7, DIO8 };
 
@@ -169,9 +107,20 @@ void setGpibState(uint8_t bits, uint8_t mask, uint8_t mode) {
 
 }
 
-#endif
-#endif
+
+/***** Read NDAC, NRFD, DAV and EOI in one go *****/
+uint8_t getGpibHsLines() {
+  uint8_t lines = 0;
+  for (uint8_t i=1; i<5; i++){
+    if (digitalRead(ctrlbus[i])) lines |= (1<<i);
+  }
+  return lines;
+}
+
+#endif  // AR488_BOARD_REGS
 
 uint8_t getGpibPinState(uint8_t pin){
   return digitalRead(pin);
 }
+
+#endif  // AR488_SIMBUS
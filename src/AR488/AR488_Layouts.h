@@ -9,8 +9,14 @@
   extern Stream& debugStream;
 #endif
 
+// Each layout checks the board it was designed for, except with the simulated
+// bus, which does not use the pins
 #ifdef AR488_MEGA32U4_MICRO
 
+#if !defined(__AVR_ATmega32U4__) && !defined(AR488_SIMBUS)
+  #error "AR488_MEGA32U4_MICRO needs a 32u4 (Leonardo/Micro/Pro Micro) board"
+#endif
+
 #define DIO1  3   /* GPIB 1  : PORTD bit 0   data pins assigned for minimum shifting */
 #define DIO2  15  /* GPIB 2  : PORTB bit 1 */
 #define DIO3  16  /* GPIB 3  : PORTB bit 2 */
@@ -31,10 +37,112 @@
 
 #endif  // AR488_MEGA32U4_MICRO
 
+#ifdef AR488_MEGA32U4_HANDWIRE
+
+#if !defined(__AVR_ATmega32U4__) && !defined(AR488_SIMBUS)
+  #error "AR488_MEGA32U4_HANDWIRE needs a 32u4 (Leonardo/Micro/Pro Micro) board"
+#endif
+
+#define DIO1  10  /* GPIB 1  : PORTB bit 6   hand wired Pro Micro */
+#define DIO2  16  /* GPIB 2  : PORTB bit 2 */
+#define DIO3  14  /* GPIB 3  : PORTB bit 3 */
+#define DIO4  15  /* GPIB 4  : PORTB bit 1 */
+#define DIO5  9   /* GPIB 13 : PORTB bit 5 */
+#define DIO6  8   /* GPIB 14 : PORTB bit 4 */
+#define DIO7  7   /* GPIB 15 : PORTE bit 6 */
+#define DIO8  6   /* GPIB 16 : PORTD bit 7 */
+
+#define IFC   4   /* GPIB 9  : PORTD bit 4 */
+#define NDAC  A3  /* GPIB 8  : PORTF bit 4 */
+#define NRFD  A2  /* GPIB 7  : PORTF bit 5 */
+#define DAV   A1  /* GPIB 6  : PORTF bit 6 */
+#define EOI   A0  /* GPIB 5  : PORTF bit 7 */
+#define REN   5   /* GPIB 17 : PORTC bit 6 */
+#define SRQ   3   /* GPIB 10 : PORTD bit 0 */
+#define ATN   2   /* GPIB 11 : PORTD bit 1 */
+
+#endif  // AR488_MEGA32U4_HANDWIRE
+
+#ifdef AR488_UNO
+
+#if !defined(__AVR_ATmega328P__) && !defined(__AVR_ATmega168__) && !defined(AR488_SIMBUS)
+  #error "AR488_UNO needs a 328P/168 (Uno/Nano) board"
+#endif
+
+#define DIO1  A0  /* GPIB 1  : PORTC bit 0   data pins on their own bit positions */
+#define DIO2  A1  /* GPIB 2  : PORTC bit 1 */
+#define DIO3  A2  /* GPIB 3  : PORTC bit 2 */
+#define DIO4  A3  /* GPIB 4  : PORTC bit 3 */
+#define DIO5  A4  /* GPIB 13 : PORTC bit 4 */
+#define DIO6  A5  /* GPIB 14 : PORTC bit 5 */
+#define DIO7  4   /* GPIB 15 : PORTD bit 4 */
+#define DIO8  5   /* GPIB 16 : PORTD bit 5 */
+
+#define IFC   8   /* GPIB 9  : PORTB bit 0   control pins on their own bit positions */
+#define NDAC  9   /* GPIB 8  : PORTB bit 1 */
+#define NRFD  10  /* GPIB 7  : PORTB bit 2 */
+#define DAV   11  /* GPIB 6  : PORTB bit 3 */
+#define EOI   12  /* GPIB 5  : PORTB bit 4 */
+#define SRQ   2   /* GPIB 10 : PORTD bit 2 */
+#define REN   3   /* GPIB 17 : PORTD bit 3 */
+#define ATN   7   /* GPIB 11 : PORTD bit 7 */
+
+#endif  // AR488_UNO
+
+#ifdef AR488_MEGA2560
+
+#if !defined(__AVR_ATmega2560__) && !defined(AR488_SIMBUS)
+  #error "AR488_MEGA2560 needs a Mega 2560 board"
+#endif
+
+#define DIO1  A0  /* GPIB 1  : PORTF bit 0   data pins on their own bit positions */
+#define DIO2  A1  /* GPIB 2  : PORTF bit 1 */
+#define DIO3  A2  /* GPIB 3  : PORTF bit 2 */
+#define DIO4  A3  /* GPIB 4  : PORTF bit 3 */
+#define DIO5  A4  /* GPIB 13 : PORTF bit 4 */
+#define DIO6  A5  /* GPIB 14 : PORTF bit 5 */
+#define DIO7  A6  /* GPIB 15 : PORTF bit 6 */
+#define DIO8  A7  /* GPIB 16 : PORTF bit 7 */
+
+#define IFC   17  /* GPIB 9  : PORTH bit 0 */
+#define NDAC  16  /* GPIB 8  : PORTH bit 1 */
+#define NRFD  6   /* GPIB 7  : PORTH bit 3 */
+#define DAV   7   /* GPIB 6  : PORTH bit 4 */
+#define EOI   8   /* GPIB 5  : PORTH bit 5 */
+#define REN   9   /* GPIB 17 : PORTH bit 6 */
+#define SRQ   10  /* GPIB 10 : PORTB bit 4 */
+#define ATN   11  /* GPIB 11 : PORTB bit 5 */
+
+#endif  // AR488_MEGA2560
+
+/***** Handshake line bits returned by getGpibHsLines() *****/
+/*
+ * Same bit positions as the setGpibState() control byte
+ */
+#define HS_NDAC 0b00000010
+#define HS_NRFD 0b00000100
+#define HS_DAV  0b00001000
+#define HS_EOI  0b00010000
+
+/***** Register level access on AVR boards *****/
+#if defined(AR488_CUSTOM) && !defined(AR488_SIMBUS) && (defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__) || defined(__AVR_ATmega32U4__) || defined(__AVR_ATmega2560__))
+  #define AR488_BOARD_REGS
+  #include "AR488_Board.h"
+#endif
+
 void readyGpibDbus();
 uint8_t readGpibDbus();
 void setGpibDbus(uint8_t db);
 void setGpibState(uint8_t bits, uint8_t mask, uint8_t mode);
 uint8_t getGpibPinState(uint8_t pin);
 
+#ifdef AR488_BOARD_REGS
+/***** Read NDAC, NRFD, DAV and EOI in one go *****/
+inline uint8_t getGpibHsLines() {
+  return BoardPorts::readHs() & 0b00011110;
+}
+#else
+uint8_t getGpibHsLines();
+#endif
+
 #endif // AR488_LAYOUTS_H
@@ -0,0 +1,293 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "AR488_Config.h"
+#include "AR488_Eeprom.h"
+#include "AR488_cmd.h"
+#include "AR488_Macro.h"
+
+#ifdef USE_MACROS
+
+#define OK  false
+#define ERR true
+
+
+/***** STARTUP MACRO *****/
+static const char startup_macro[] PROGMEM = {MACRO_0};
+
+/***** Consts holding USER MACROS 1 - 9 *****/
+static const char macro_1 [] PROGMEM = {MACRO_1};
+static const char macro_2 [] PROGMEM = {MACRO_2};
+static const char macro_3 [] PROGMEM = {MACRO_3};
+static const char macro_4 [] PROGMEM = {MACRO_4};
+static const char macro_5 [] PROGMEM = {MACRO_5};
+static const char macro_6 [] PROGMEM = {MACRO_6};
+static const char macro_7 [] PROGMEM = {MACRO_7};
+static const char macro_8 [] PROGMEM = {MACRO_8};
+static const char macro_9 [] PROGMEM = {MACRO_9};
+
+static const char * const macros[] PROGMEM = {
+  startup_macro,
+  macro_1,
+  macro_2,
+  macro_3,
+  macro_4,
+  macro_5,
+  macro_6,
+  macro_7,
+  macro_8,
+  macro_9
+};
+
+
+/***** Return the (PROGMEM) text of a built-in macro *****/
+const char *mcText(uint8_t idx) {
+  return (const char *)pgm_read_ptr(macros + idx);
+}
+
+
+#ifdef MACRO_STORE
+
+/***** Compile a line into a record *****/
+/*
+ * Returns the record type with the payload and its length. Nothing is
+ * compiled (MC_END) for an empty line. The payload is limited to
+ * MC_LINE_LEN - 1 bytes so that a record always fits the parse buffer.
+ */
+static uint8_t mcCompile(char *line, struct mcRec &rec, char *&payload) {
+  struct cmdRec cmd;
+  char *token;
+  char *params;
+  char sc;
+  int idx;
+  uint16_t len;
+
+  // Strip trailing CR/LF
+  len = strlen(line);
+  while (len && ((line[len-1] == '\r') || (line[len-1] == '\n'))) line[--len] = '\0';
+  if (len == 0) return MC_END;
+  if (len > (MC_LINE_LEN - 1)) len = MC_LINE_LEN - 1;
+
+  rec.cidx = 0;
+  rec.len = 0;
+  payload = line;
+
+  if ((line[0] != '+') || (line[1] != '+')) {
+    rec.op = MC_DATA;
+    rec.len = len;
+    return MC_DATA;
+  }
+
+  // Find the command handler
+  token = line + 2;
+  params = token;
+  while (*params && (*params != ' ') && (*params != '\t')) params++;
+  sc = *params;
+  *params = '\0';
+  idx = getCmdRec(token, &cmd);
+  *params = sc;
+  if (idx < 0) {
+    rec.op = MC_BADCMD;
+    return MC_BADCMD;
+  }
+
+  // Parameters
+  while ((*params == ' ') || (*params == '\t')) params++;
+  rec.op = MC_CMD;
+  rec.cidx = (uint8_t)idx;
+  len = strlen(params);
+  rec.len = (len > (MC_LINE_LEN - 1)) ? (MC_LINE_LEN - 1) : len;
+  payload = params;
+  return MC_CMD;
+}
+
+/***** Size of a record in the store *****/
+static uint16_t mcRecSize(struct mcRec &rec) {
+  switch (rec.op) {
+    case MC_CMD:  return 3 + rec.len;
+    case MC_DATA: return 2 + rec.len;
+    default:      return 1;
+  }
+}
+
+/***** Write a record to the store *****/
+static uint16_t mcWrite(uint16_t addr, struct mcRec &rec, const char *payload) {
+  EEPROM.update(addr++, rec.op);
+  if (rec.op == MC_CMD) EEPROM.update(addr++, rec.cidx);
+  if ((rec.op == MC_CMD) || (rec.op == MC_DATA)) {
+    EEPROM.update(addr++, rec.len);
+    for (uint8_t i=0; i<rec.len; i++) {
+      EEPROM.update(addr++, payload[i]);
+    }
+  }
+  return addr;
+}
+
+/***** Move part of the store up or down *****/
+static void mcMove(uint16_t from, uint16_t to, uint16_t cnt) {
+  if (to > from) {
+    for (uint16_t i=cnt; i>0; i--) EEPROM.update(to+i-1, EEPROM.read(from+i-1));
+  }else{
+    for (uint16_t i=0; i<cnt; i++) EEPROM.update(to+i, EEPROM.read(from+i));
+  }
+}
+
+/***** Key identifying the built-in macros and command table *****/
+/*
+ * Records hold the index of their command in cmdHidx, so the tokens are
+ * included in order: adding, removing or renaming a command changes the key.
+ */
+static uint16_t mcKey() {
+  struct cmdRec cmd;
+  uint16_t crc = 0xFFFF;
+  uint8_t c;
+  const char *macro;
+
+  for (uint8_t i=0; i<MC_COUNT; i++) {
+    macro = mcText(i);
+    while ((c = pgm_read_byte(macro++))) crc = getCRC16(&c, 1, crc);
+    c = 0;
+    crc = getCRC16(&c, 1, crc);
+  }
+  for (uint8_t i=0; i<cmdHidxSize; i++) {
+    memcpy_P(&cmd, &cmdHidx[i], sizeof(struct cmdRec));
+    while ((c = pgm_read_byte(cmd.token++))) crc = getCRC16(&c, 1, crc);
+    c = 0;
+    crc = getCRC16(&c, 1, crc);
+  }
+  return crc;
+}
+
+
+/***** Compile the built-in macros into the store if they have changed *****/
+void mcInit() {
+  char line[MC_LINE_LEN];
+  struct mcRec rec;
+  char *payload;
+  const char *macro;
+  uint16_t key;
+  uint16_t skey;
+  uint16_t addr = MC_EESTART + sizeof(key);
+  uint8_t p;
+  char c;
+
+  key = mcKey();
+  EEPROM.get(MC_EESTART, skey);
+  if (skey == key) return;
+
+  for (uint8_t i=0; i<MC_COUNT; i++) {
+    macro = mcText(i);
+    do {
+      // Next line
+      p = 0;
+      while ((c = pgm_read_byte(macro)) && (c != '\n')) {
+        if (p < (MC_LINE_LEN - 1)) line[p++] = c;
+        macro++;
+      }
+      if (c) macro++;
+      line[p] = '\0';
+      // Compile, leaving room for the end markers
+      if (mcCompile(line, rec, payload) != MC_END) {
+        if ((addr + mcRecSize(rec) + (MC_COUNT - i)) <= MC_EEEND) addr = mcWrite(addr, rec, payload);
+      }
+    } while (c);
+    rec.op = MC_END;
+    addr = mcWrite(addr, rec, NULL);
+  }
+
+  EEPROM.put(MC_EESTART, key);
+}
+
+
+/***** Read the record at addr *****/
+/*
+ * The parameters or data are copied to buf (if not NULL, at least MC_LINE_LEN
+ * bytes) and terminated. A longer record (a corrupt store) is cut short.
+ * Returns the address of the next record or 0 at the end of the macro.
+ */
+uint16_t mcRead(uint16_t addr, struct mcRec &rec, char *buf) {
+  uint16_t next;
+
+  if (addr >= MC_EEEND) return 0;
+  rec.op = EEPROM.read(addr++);
+  rec.cidx = 0;
+  rec.len = 0;
+  switch (rec.op) {
+    case MC_CMD:
+      rec.cidx = EEPROM.read(addr++);
+      // Fall through
+    case MC_DATA:
+      rec.len = EEPROM.read(addr++);
+      next = addr + rec.len;
+      if (rec.len > (MC_LINE_LEN - 1)) rec.len = MC_LINE_LEN - 1;
+      if (buf) {
+        for (uint8_t i=0; i<rec.len; i++) buf[i] = EEPROM.read(addr+i);
+        buf[rec.len] = '\0';
+      }
+      return next;
+    case MC_BADCMD:
+      return addr;
+    default:
+      // End of macro (or store not written)
+      return 0;
+  }
+}
+
+
+/***** Address of the first record of a macro *****/
+/*
+ * mcFind(MC_COUNT) returns the end of the data in the store.
+ */
+uint16_t mcFind(uint8_t idx) {
+  struct mcRec rec;
+  uint16_t addr = MC_EESTART + sizeof(uint16_t);
+  uint16_t next;
+
+  for (uint8_t i=0; i<idx; i++) {
+    while ((next = mcRead(addr, rec, NULL))) addr = next;
+    // Step over the end marker
+    if (addr < MC_EEEND) addr++;
+  }
+  return addr;
+}
+
+
+/***** Has the macro any lines? *****/
+bool mcIsDefined(uint8_t idx) {
+  struct mcRec rec;
+  return (mcRead(mcFind(idx), rec, NULL) != 0);
+}
+
+
+/***** Add a line to the end of a macro *****/
+bool mcAdd(uint8_t idx, char *line) {
+  struct mcRec rec;
+  char *payload;
+  uint16_t pos;
+  uint16_t used;
+  uint16_t rsize;
+
+  if (mcCompile(line, rec, payload) == MC_END) return OK;
+
+  rsize = mcRecSize(rec);
+  pos = mcFind(idx + 1) - 1;    // End marker of the macro
+  used = mcFind(MC_COUNT);
+  if ((used + rsize) > MC_EEEND) return ERR;
+
+  mcMove(pos, pos + rsize, used - pos);
+  mcWrite(pos, rec, payload);
+  return OK;
+}
+
+
+/***** Remove all lines from a macro *****/
+void mcClear(uint8_t idx) {
+  uint16_t start = mcFind(idx);
+  uint16_t end = mcFind(idx + 1) - 1;   // End marker of the macro
+  uint16_t used = mcFind(MC_COUNT);
+
+  mcMove(end, start, used - end);
+}
+
+#endif  // MACRO_STORE
+
+#endif  // USE_MACROS
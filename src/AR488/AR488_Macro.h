@@ -0,0 +1,61 @@
+#ifndef AR488_MACRO_H
+#define AR488_MACRO_H
+
+#include <Arduino.h>
+#include "AR488_Config.h"
+#include "AR488_Eeprom.h"
+
+#ifdef USE_MACROS
+
+
+#define MC_COUNT 10       // Macro 0 (startup) and user macros 1-9
+#define MC_LINE_LEN 128   // Longest macro line that can be compiled
+
+// Records are read back into the parse buffer
+static_assert(MC_LINE_LEN <= PBSIZE, "MC_LINE_LEN must not exceed PBSIZE");
+
+
+/***** Compiled macro store *****/
+/*
+ * Macros are compiled into a compact token stream held in the EEPROM above
+ * the config area. Each line becomes one record: a command line holds the
+ * index of its handler in cmdHidx followed by its parameters, and a data line
+ * holds the bytes to send to the instrument. Running a macro then needs no
+ * parsing or command lookup. The built-in macros are compiled at power-up
+ * only when they (or the command table) have changed since they were last
+ * stored. Lines can also be added at runtime with ++macro add.
+ */
+#if defined(E2END) && ((E2END + 1) >= (EESIZE + 128))
+  #define MACRO_STORE
+  #define MC_EESTART EESIZE
+  #define MC_EEEND (E2END + 1)
+#endif
+
+/***** Record types *****/
+#define MC_END 0          // End of macro
+#define MC_CMD 1          // ++ command: handler index, length, parameters
+#define MC_DATA 2         // Instrument data: length, data
+#define MC_BADCMD 3       // Unrecognised ++ command
+
+struct mcRec {
+  uint8_t op;
+  uint8_t cidx;           // Command handler index (MC_CMD)
+  uint8_t len;            // Length of parameters or data
+};
+
+
+const char *mcText(uint8_t idx);
+
+#ifdef MACRO_STORE
+void mcInit();
+uint16_t mcFind(uint8_t idx);
+uint16_t mcRead(uint16_t addr, struct mcRec &rec, char *buf);
+bool mcAdd(uint8_t idx, char *line);
+void mcClear(uint8_t idx);
+bool mcIsDefined(uint8_t idx);
+#endif
+
+
+#endif  // USE_MACROS
+
+#endif  // AR488_MACRO_H
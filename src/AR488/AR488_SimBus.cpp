@@ -0,0 +1,259 @@
+#include <Arduino.h>
+#include "AR488_Config.h"
+#include "AR488_Layouts.h"
+#include "AR488_SimBus.h"
+
+#ifdef AR488_SIMBUS
+
+
+/***** Line bits (setGpibState() control byte positions) *****/
+#define SL_IFC  0x01
+#define SL_NDAC 0x02
+#define SL_NRFD 0x04
+#define SL_DAV  0x08
+#define SL_EOI  0x10
+#define SL_ATN  0x80
+
+/***** Instrument handshake states *****/
+#define ACC_IDLE   0    // Not taking part in the handshake
+#define ACC_READY  1    // NDAC asserted, NRFD released - waiting for DAV
+#define ACC_ACCEPT 2    // Byte taken - waiting for DAV to be released
+
+#define SRC_IDLE   0    // Not talking
+#define SRC_READY  1    // Waiting for NRFD released and NDAC asserted
+#define SRC_VALID  2    // DAV asserted - waiting for NDAC released
+#define SRC_DONE   3    // Response sent
+
+
+struct simStats simStat;
+uint8_t simDelay = 0;
+uint16_t simLen = SIM_MSG_LEN;
+
+static constexpr uint8_t simPins[8] = { IFC, NDAC, NRFD, DAV, EOI, REN, SRQ, ATN };
+
+// Lines driven by the interface
+static uint8_t ctlDir = 0;      // 1 = output
+static uint8_t ctlState = 0xFF; // 0 = LOW
+static bool dbusOut = false;
+static uint8_t dbusVal = 0;
+
+// Lines driven by the instruments (1 = asserted)
+static uint8_t devLines = 0;
+static uint8_t devData = 0;
+
+static bool devListen[SIM_DEVICES];
+static bool devTalk[SIM_DEVICES];
+static bool spMode = false;
+static uint8_t accState = ACC_IDLE;
+static uint8_t accWait = 0;
+static uint8_t srcState = SRC_IDLE;
+static uint8_t srcWait = 0;
+static uint16_t srcPos = 0;
+
+
+/***** Control lines asserted by either side *****/
+static uint8_t simAsserted() {
+  return (ctlDir & ~ctlState) | devLines;
+}
+
+static bool anyListener() {
+  for (uint8_t i = 0; i < SIM_DEVICES; i++) {
+    if (devListen[i]) return true;
+  }
+  return false;
+}
+
+static bool anyTalker() {
+  for (uint8_t i = 0; i < SIM_DEVICES; i++) {
+    if (devTalk[i]) return true;
+  }
+  return false;
+}
+
+static void simReset() {
+  for (uint8_t i = 0; i < SIM_DEVICES; i++) {
+    devListen[i] = false;
+    devTalk[i] = false;
+  }
+  spMode = false;
+  devLines = 0;
+  devData = 0;
+  accState = ACC_IDLE;
+  srcState = SRC_IDLE;
+}
+
+/***** A byte taken by the instruments *****/
+static void simAccept(uint8_t db, bool atn) {
+  simStat.bytes++;
+  if (!atn) return;   // Data is discarded
+
+  db &= 0x7F;
+  if (db == 0x3F) {           // UNL
+    for (uint8_t i = 0; i < SIM_DEVICES; i++) devListen[i] = false;
+  } else if (db == 0x5F) {    // UNT
+    for (uint8_t i = 0; i < SIM_DEVICES; i++) devTalk[i] = false;
+  } else if (db == 0x18) {    // SPE
+    spMode = true;
+  } else if (db == 0x19) {    // SPD
+    spMode = false;
+  } else if ((db & 0x60) == 0x20) {   // LAD
+    for (uint8_t i = 0; i < SIM_DEVICES; i++) {
+      if ((db & 0x1F) == (SIM_ADDR + i)) devListen[i] = true;
+    }
+  } else if ((db & 0x60) == 0x40) {   // TAD - any other talker stops
+    for (uint8_t i = 0; i < SIM_DEVICES; i++) devTalk[i] = ((db & 0x1F) == (SIM_ADDR + i));
+    srcState = SRC_IDLE;
+  }
+}
+
+/***** Byte number pos of the response *****/
+static uint8_t simByte(uint16_t pos, bool &last) {
+  if (spMode) {
+    last = true;
+    return 0x00;    // Status byte
+  }
+  last = (pos == (simLen - 1));
+  return last ? '\n' : ('A' + (pos % 26));
+}
+
+/***** Advance the instruments (called on every read of the handshake lines) *****/
+static void simStep() {
+  uint8_t bus = simAsserted();
+  bool atn = bus & SL_ATN;
+  bool last;
+
+  if (bus & SL_IFC) {
+    simReset();
+    return;
+  }
+
+  // Acceptor: all devices take commands, and data when addressed to listen.
+  // Devices leave the handshake at once when they stop taking part
+  if (!(atn || anyListener())) {
+    devLines &= ~(SL_NDAC | SL_NRFD);
+    accState = ACC_IDLE;
+    accWait = 0;
+  } else if (accWait) {
+    accWait--;
+  } else {
+    switch (accState) {
+      case ACC_IDLE:
+        devLines = (devLines | SL_NDAC) & ~SL_NRFD;
+        accState = ACC_READY;
+        accWait = simDelay;
+        break;
+      case ACC_READY:
+        if (bus & SL_DAV) {
+          simAccept((dbusOut ? dbusVal : 0) | devData, atn);
+          // Busy, then data accepted
+          devLines = (devLines | SL_NRFD) & ~SL_NDAC;
+          accState = ACC_ACCEPT;
+          accWait = simDelay;
+        }
+        break;
+      case ACC_ACCEPT:
+        if (!(bus & SL_DAV)) {
+          devLines = (devLines | SL_NDAC) & ~SL_NRFD;
+          accState = ACC_READY;
+          accWait = simDelay;
+        }
+        break;
+    }
+  }
+
+  // Source: the addressed talker sends while ATN is unasserted
+  if (srcWait) {
+    srcWait--;
+    return;
+  }
+  if (atn || !anyTalker()) {
+    if (srcState == SRC_VALID) {
+      devLines &= ~(SL_DAV | SL_EOI);
+      devData = 0;
+    }
+    if (!anyTalker()) srcState = SRC_IDLE;
+    else if (srcState == SRC_VALID) srcState = SRC_READY;
+    return;
+  }
+  switch (srcState) {
+    case SRC_IDLE:
+      srcPos = 0;
+      srcState = SRC_READY;
+      break;
+    case SRC_READY:
+      if (!(bus & SL_NRFD) && (bus & SL_NDAC)) {
+        devData = simByte(srcPos, last);
+        devLines |= SL_DAV | ((last && !spMode) ? SL_EOI : 0);
+        srcState = SRC_VALID;
+        srcWait = simDelay;
+      }
+      break;
+    case SRC_VALID:
+      if (!(bus & SL_NDAC)) {
+        simByte(srcPos, last);
+        devLines &= ~(SL_DAV | SL_EOI);
+        devData = 0;
+        simStat.bytes++;
+        srcPos++;
+        srcState = last ? SRC_DONE : SRC_READY;
+        srcWait = simDelay;
+      }
+      break;
+  }
+}
+
+
+void simClearStats() {
+  memset(&simStat, 0, sizeof(simStat));
+}
+
+
+/***** Layout functions *****/
+
+void readyGpibDbus() {
+  simStat.dbusWrites++;
+  dbusOut = false;
+}
+
+uint8_t readGpibDbus() {
+  simStat.dbusReads++;
+  return (dbusOut ? dbusVal : 0) | devData;
+}
+
+void setGpibDbus(uint8_t db) {
+  simStat.dbusWrites++;
+  dbusOut = true;
+  dbusVal = db;
+}
+
+void setGpibState(uint8_t bits, uint8_t mask, uint8_t mode) {
+  simStat.ctrlSets++;
+  switch (mode) {
+    case 0:
+      ctlState = (ctlState & ~mask) | (bits & mask);
+      break;
+    case 1:
+      // Inputs have pullups
+      ctlDir = (ctlDir & ~mask) | (bits & mask);
+      ctlState |= (mask & ~bits);
+      break;
+  }
+}
+
+uint8_t getGpibHsLines() {
+  simStat.hsReads++;
+  simStep();
+  return ~simAsserted() & 0b00011110;
+}
+
+uint8_t getGpibPinState(uint8_t pin) {
+  simStat.hsReads++;
+  simStep();
+  for (uint8_t i = 0; i < 8; i++) {
+    if (simPins[i] == pin) return (simAsserted() & (1 << i)) ? LOW : HIGH;
+  }
+  return HIGH;
+}
+
+
+#endif  // AR488_SIMBUS
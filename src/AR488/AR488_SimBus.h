@@ -0,0 +1,39 @@
+#ifndef AR488_SIMBUS_H
+#define AR488_SIMBUS_H
+
+#include <Arduino.h>
+#include "AR488_Config.h"
+
+
+/***** Simulated bus *****/
+/*
+ * With AR488_SIMBUS defined the pin functions of AR488_Layouts.cpp are replaced
+ * by a model of the bus lines with SIM_DEVICES virtual instruments attached at
+ * addresses SIM_ADDR onwards. The instruments decode the addressing and serial
+ * poll commands, accept data when addressed to listen and send a response of
+ * simLen bytes (the last with EOI) when addressed to talk. Each of their
+ * handshake edges follows the controller's after simDelay reads of the lines,
+ * so results are repeatable. The calls made to the line functions are counted
+ * which gives the cost per byte of each handshake mode (++fasths, ++hs488)
+ * with ++bench, without a bus or instruments connected.
+ */
+
+#ifdef AR488_SIMBUS
+
+struct simStats {
+  uint32_t hsReads;     // Handshake line reads (getGpibHsLines/getGpibPinState)
+  uint32_t ctrlSets;    // setGpibState() calls
+  uint32_t dbusReads;   // readGpibDbus() calls
+  uint32_t dbusWrites;  // setGpibDbus()/readyGpibDbus() calls
+  uint32_t bytes;       // Bytes accepted by the instruments or sent by them
+};
+
+extern struct simStats simStat;
+extern uint8_t simDelay;    // Line reads before an instrument responds
+extern uint16_t simLen;     // Length of an instrument response
+
+void simClearStats();
+
+#endif  // AR488_SIMBUS
+
+#endif  // AR488_SIMBUS_H
@@ -0,0 +1,88 @@
+#include <Arduino.h>
+#include "AR488_Config.h"
+#include "AR488_Trace.h"
+
+#ifdef TRACE_ENABLE
+
+#if (TRACE_SIZE & (TRACE_SIZE - 1)) || (TRACE_SIZE > 128)
+#error TRACE_SIZE must be a power of 2 no larger than 128
+#endif
+
+
+traceRec traceBuf[TRACE_SIZE];
+volatile uint8_t traceHead = 0;
+volatile uint8_t traceCnt = 0;
+volatile bool traceOn = true;
+
+
+/***** Event names (indexed by event ID) *****/
+static const char trn_unk[] PROGMEM = "?";
+static const char trn_rd[] PROGMEM = "RD";
+static const char trn_rdeoi[] PROGMEM = "RD+EOI";
+static const char trn_wr[] PROGMEM = "WR";
+static const char trn_wreoi[] PROGMEM = "WR+EOI";
+static const char trn_cmd[] PROGMEM = "CMD";
+static const char trn_atn[] PROGMEM = "ATN";
+static const char trn_rdabt[] PROGMEM = "RDABORT";
+static const char trn_wrabt[] PROGMEM = "WRABORT";
+static const char trn_ctrl[] PROGMEM = "CTRL";
+static const char trn_ifc[] PROGMEM = "IFC";
+static const char trn_hs[] PROGMEM = "HS488";
+
+static const char * const traceNames[] PROGMEM = {
+  trn_unk,
+  trn_rd,
+  trn_rdeoi,
+  trn_wr,
+  trn_wreoi,
+  trn_cmd,
+  trn_atn,
+  trn_rdabt,
+  trn_wrabt,
+  trn_ctrl,
+  trn_ifc,
+  trn_hs
+};
+
+
+void traceClear() {
+  uint8_t sreg = SREG;
+  cli();
+  traceHead = 0;
+  traceCnt = 0;
+  SREG = sreg;
+}
+
+
+/***** Print the buffer, oldest first, and clear it *****/
+/*
+ * Each line holds the time in microseconds relative to the first record,
+ * the event and its value in hex.
+ */
+void tracePrint(Stream& outputStream) {
+  bool on = traceOn;
+  uint8_t idx;
+  uint8_t id;
+  uint32_t t0;
+  char hex[3];
+
+  // Stop logging while the buffer is read out
+  traceOn = false;
+  idx = (traceHead - traceCnt) & (TRACE_SIZE - 1);
+  t0 = traceBuf[idx].t;
+  for (uint8_t i=0; i<traceCnt; i++) {
+    id = traceBuf[idx].id;
+    if (id >= (sizeof(traceNames) / sizeof(traceNames[0]))) id = 0;
+    outputStream.print(traceBuf[idx].t - t0);
+    outputStream.print(' ');
+    outputStream.print((const __FlashStringHelper *)pgm_read_ptr(traceNames + id));
+    outputStream.print(' ');
+    sprintf_P(hex, PSTR("%02X"), traceBuf[idx].val);
+    outputStream.println(hex);
+    idx = (idx + 1) & (TRACE_SIZE - 1);
+  }
+  traceClear();
+  traceOn = on;
+}
+
+#endif  // TRACE_ENABLE
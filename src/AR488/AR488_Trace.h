@@ -0,0 +1,70 @@
+#ifndef AR488_TRACE_H
+#define AR488_TRACE_H
+
+#include <Arduino.h>
+#include "AR488_Config.h"
+
+
+/***** Bus trace *****/
+/*
+ * Bus events are logged as fixed size binary records into a RAM ring buffer,
+ * which only takes a few microseconds per event so that handshake timing is
+ * hardly affected. The buffer is printed afterwards with ++trace.
+ */
+
+/***** Trace event IDs *****/
+#define TR_RD     1   // Data byte read
+#define TR_RDEOI  2   // Data byte read with EOI
+#define TR_WR     3   // Data byte written
+#define TR_WREOI  4   // Data byte written with EOI
+#define TR_CMD    5   // Command byte sent (ATN asserted)
+#define TR_ATN    6   // Command byte received in device mode
+#define TR_RDABT  7   // Read handshake aborted (value = stage)
+#define TR_WRABT  8   // Write handshake aborted (value = stage)
+#define TR_CTRL   9   // Control state set by setControls()
+#define TR_IFC   10   // IFC pulse sent
+#define TR_HS    11   // HS488 negotiated (value = HS488_xxx state)
+
+
+#ifdef TRACE_ENABLE
+
+struct traceRec {
+  uint32_t t;       // micros()
+  uint8_t id;
+  uint8_t val;
+};
+
+extern traceRec traceBuf[TRACE_SIZE];
+extern volatile uint8_t traceHead;
+extern volatile uint8_t traceCnt;
+extern volatile bool traceOn;
+
+/***** Log an event *****/
+inline void traceLog(uint8_t id, uint8_t val) {
+  uint8_t sreg;
+  uint8_t h;
+
+  if (!traceOn) return;
+  // Only logged from the main line: ATN commands are traced by decodeAtn() in
+  // loop() and the ATN/SRQ interrupts log nothing. Interrupts are still
+  // disabled so that this stays safe if an interrupt ever logs an event.
+  sreg = SREG;
+  cli();
+  h = traceHead;
+  traceBuf[h].t = micros();
+  traceBuf[h].id = id;
+  traceBuf[h].val = val;
+  traceHead = (h + 1) & (TRACE_SIZE - 1);
+  if (traceCnt < TRACE_SIZE) traceCnt++;
+  SREG = sreg;
+}
+
+void traceClear();
+void tracePrint(Stream& outputStream);
+
+  #define TRACE(id, val) traceLog((id), (val))
+#else
+  #define TRACE(id, val)
+#endif  // TRACE_ENABLE
+
+#endif  // AR488_TRACE_H
@@ -0,0 +1,311 @@
+#include <Arduino.h>
+#include "AR488_Config.h"
+#include "AR488_USBTMC.h"
+
+#ifdef AR488_USBTMC
+
+#define OK  false
+#define ERR true
+
+
+USBTMC_ Usbtmc;
+
+
+USBTMC_::USBTMC_() : PluggableUSBModule(2, 1, epType) {
+  epType[0] = EP_TYPE_BULK_OUT;
+  epType[1] = EP_TYPE_BULK_IN;
+  outRemaining = 0;
+  outReceived = 0;
+  outEom = false;
+  outTag = 0;
+  inAddressed = false;
+  inTag = 0;
+  clearReq = false;
+  abortOut = false;
+  abortIn = false;
+  PluggableUSB().plug(this);
+}
+
+uint8_t USBTMC_::outEp() {
+  return pluggedEndpoint;
+}
+
+uint8_t USBTMC_::inEp() {
+  return pluggedEndpoint + 1;
+}
+
+
+/***** USB descriptors *****/
+
+int USBTMC_::getInterface(uint8_t *interfaceCount) {
+  *interfaceCount += 1;
+  TMCDescriptor desc = {
+    D_INTERFACE(pluggedInterface, 2, USBTMC_CLASS, USBTMC_SUBCLASS, USBTMC_PROTOCOL),
+    D_ENDPOINT((uint8_t)USB_ENDPOINT_OUT(outEp()), USB_ENDPOINT_TYPE_BULK, USBTMC_EP_SIZE, 0),
+    D_ENDPOINT((uint8_t)USB_ENDPOINT_IN(inEp()), USB_ENDPOINT_TYPE_BULK, USBTMC_EP_SIZE, 0)
+  };
+  return USB_SendControl(0, &desc, sizeof(desc));
+}
+
+int USBTMC_::getDescriptor(USBSetup &setup) {
+  setup = setup;  // No class specific descriptors
+  return 0;
+}
+
+uint8_t USBTMC_::getShortName(char *name) {
+  memcpy(name, "TMC", 3);
+  return 3;
+}
+
+
+/***** Class requests on the control endpoint *****/
+/*
+ * These run from the USB interrupt, so anything that needs the GPIB bus is
+ * flagged here and carried out by service().
+ */
+bool USBTMC_::setup(USBSetup &setup) {
+  uint8_t resp[24] = {0};
+  uint8_t rlen = 0;
+  uint8_t recipient = setup.bmRequestType & REQUEST_RECIPIENT;
+
+  if ((setup.bmRequestType & REQUEST_TYPE) != REQUEST_CLASS) return false;
+
+  if (recipient == REQUEST_INTERFACE) {
+    if (setup.wIndex != pluggedInterface) return false;
+    switch (setup.bRequest) {
+      case TMC_GET_CAPABILITIES:
+        resp[0] = TMC_STATUS_SUCCESS;
+        resp[2] = 0x00;   // bcdUSBTMC 1.00
+        resp[3] = 0x01;
+        resp[4] = 0x00;   // No indicator pulse, not talk-only or listen-only
+        resp[5] = 0x01;   // TermChar supported
+        rlen = 24;
+        break;
+      case TMC_INITIATE_CLEAR:
+        clearReq = true;
+        resp[0] = TMC_STATUS_SUCCESS;
+        rlen = 1;
+        break;
+      case TMC_CHECK_CLEAR_STATUS:
+        resp[0] = clearReq ? TMC_STATUS_PENDING : TMC_STATUS_SUCCESS;
+        rlen = 2;
+        break;
+      default:
+        return false;
+    }
+
+  } else if (recipient == REQUEST_ENDPOINT) {
+    uint8_t ep = setup.wIndex & 0x0F;
+    uint8_t tag = setup.wValueL;
+    switch (setup.bRequest) {
+      case TMC_INITIATE_ABORT_BULK_OUT:
+        if (ep != outEp()) return false;
+        if (outRemaining && (tag == outTag)) {
+          abortOut = true;
+          resp[0] = TMC_STATUS_SUCCESS;
+        } else {
+          resp[0] = TMC_STATUS_NOT_IN_PROGRESS;
+        }
+        resp[1] = outTag;
+        rlen = 2;
+        break;
+      case TMC_CHECK_ABORT_BULK_OUT_STATUS:
+        if (ep != outEp()) return false;
+        resp[0] = abortOut ? TMC_STATUS_PENDING : TMC_STATUS_SUCCESS;
+        memcpy(&resp[4], (const void *)&outReceived, 4);
+        rlen = 8;
+        break;
+      case TMC_INITIATE_ABORT_BULK_IN:
+        if (ep != inEp()) return false;
+        if (inAddressed && (tag == inTag)) {
+          abortIn = true;
+          resp[0] = TMC_STATUS_SUCCESS;
+        } else {
+          resp[0] = TMC_STATUS_NOT_IN_PROGRESS;
+        }
+        resp[1] = inTag;
+        rlen = 2;
+        break;
+      case TMC_CHECK_ABORT_BULK_IN_STATUS:
+        if (ep != inEp()) return false;
+        resp[0] = abortIn ? TMC_STATUS_PENDING : TMC_STATUS_SUCCESS;
+        rlen = 8;
+        break;
+      default:
+        return false;
+    }
+
+  } else {
+    return false;
+  }
+
+  USB_SendControl(0, resp, rlen);
+  return true;
+}
+
+
+/***** Service the bulk endpoints - called from loop() in controller mode *****/
+void USBTMC_::service(GPIBbus &bus) {
+  int n;
+  uint32_t tsize;
+
+  if (clearReq) {
+    // Device clear: drop any message in progress and clear the instrument
+    endTransfers(bus);
+    while (USB_Available(outEp())) USB_Recv(outEp(), pkt, USBTMC_EP_SIZE);
+    bus.sendSDC();
+    bus.setControls(CIDS);
+    clearReq = false;
+  }
+
+  if (abortOut) {
+    // Discard the rest of the OUT message
+    while (USB_Available(outEp())) USB_Recv(outEp(), pkt, USBTMC_EP_SIZE);
+    if (outRemaining) bus.unAddressDevice();
+    bus.setControls(CIDS);
+    outRemaining = 0;
+    abortOut = false;
+  }
+
+  if (abortIn) {
+    endTransfers(bus);
+    abortIn = false;
+  }
+
+  if (!USB_Available(outEp())) return;
+
+  n = USB_Recv(outEp(), pkt, USBTMC_EP_SIZE);
+  if (n <= 0) return;
+
+  // Continuation of a DEV_DEP_MSG_OUT message
+  if (outRemaining) {
+    writeOut(bus, pkt, n);
+    return;
+  }
+
+  // Start of a transfer: check the header
+  if (n < USBTMC_HDR_SIZE) return;
+  if (pkt[1] != (uint8_t)~pkt[2]) return;
+
+  tsize = (uint32_t)pkt[4] | ((uint32_t)pkt[5] << 8) | ((uint32_t)pkt[6] << 16) | ((uint32_t)pkt[7] << 24);
+
+  switch (pkt[0]) {
+    case TMC_DEV_DEP_MSG_OUT:
+      // A new message ends any response still being read
+      if (inAddressed) endTransfers(bus);
+      outTag = pkt[1];
+      outRemaining = tsize;
+      outReceived = 0;
+      outEom = pkt[8] & 0x01;
+      if (!outRemaining || bus.addressDevice(bus.cfg.paddr, LISTEN)) {
+        outRemaining = 0;
+        return;
+      }
+      writeOut(bus, pkt + USBTMC_HDR_SIZE, n - USBTMC_HDR_SIZE);
+      break;
+    case TMC_REQUEST_DEV_DEP_MSG_IN:
+      sendIn(bus, pkt[1], tsize, pkt[8] & 0x02, pkt[9]);
+      break;
+  }
+}
+
+/***** Write message bytes to the instrument *****/
+/*
+ * Alignment padding after the last byte is discarded. EOI is asserted with
+ * the last byte of a message that has EOM set, regardless of the ++eoi setting.
+ */
+void USBTMC_::writeOut(GPIBbus &bus, uint8_t *data, uint8_t len) {
+  bool err = false;
+  bool last;
+
+  if (len > outRemaining) len = outRemaining;
+
+  bus.setControls(CTAS);
+  for (uint8_t i = 0; (i < len) && !err; i++) {
+    last = (outRemaining == 1);
+    err = bus.writeByte(data[i], last, last && outEom);
+    outRemaining--;
+    outReceived++;
+  }
+
+  if (err) outRemaining = 0;
+
+  if (outRemaining == 0) {
+    bus.unAddressDevice();
+    bus.setControls(CIDS);
+  }
+}
+
+/***** Read from the instrument and return a DEV_DEP_MSG_IN transfer *****/
+/*
+ * The header carries the number of bytes in the transfer, so the response is
+ * read into the buffer first and then sent out of one transfer as 64-byte
+ * packets (USB_Send ends it with a short or zero length packet). The
+ * instrument stays addressed to talk until EOI or TermChar ends the message,
+ * so that a response longer than USBTMC_IN_MAX is returned over several
+ * transfers.
+ */
+void USBTMC_::sendIn(GPIBbus &bus, uint8_t tag, uint32_t maxlen, bool termEn, uint8_t termChar) {
+  uint16_t cnt = 0;
+  uint16_t len;
+  uint8_t db = 0;
+  uint8_t r = 0;
+  bool eoiDetected = false;
+  bool termFound = false;
+
+  len = (maxlen < USBTMC_IN_MAX) ? (uint16_t)maxlen : USBTMC_IN_MAX;
+
+  inTag = tag;
+  if (!inAddressed) {
+    if (bus.addressDevice(bus.cfg.paddr, TALK)) r = 1;
+    inAddressed = true;
+  }
+  bus.setControls(CLAS);
+
+  while ((r == 0) && (cnt < len)) {
+    r = bus.readByte(&db, true, &eoiDetected);
+    if (r) break;
+    pkt[USBTMC_HDR_SIZE + cnt] = db;
+    cnt++;
+    if (eoiDetected) break;
+    if (termEn && (db == termChar)) {
+      termFound = true;
+      break;
+    }
+  }
+
+  // A read error also ends the message with whatever has been received
+  if (eoiDetected || termFound || r) endTransfers(bus);
+
+  pkt[0] = TMC_DEV_DEP_MSG_IN;
+  pkt[1] = tag;
+  pkt[2] = ~tag;
+  pkt[3] = 0;
+  pkt[4] = cnt & 0xFF;
+  pkt[5] = cnt >> 8;
+  pkt[6] = 0;
+  pkt[7] = 0;
+  pkt[8] = (inAddressed ? 0x00 : 0x01) | (termFound ? 0x02 : 0x00);
+  pkt[9] = 0;
+  pkt[10] = 0;
+  pkt[11] = 0;
+
+  // Pad to a multiple of 4 bytes
+  len = USBTMC_HDR_SIZE + cnt;
+  while (len & 0x03) pkt[len++] = 0;
+
+  USB_Send(inEp() | TRANSFER_RELEASE, pkt, len);
+}
+
+/***** Release the instrument when a message ends or is aborted *****/
+void USBTMC_::endTransfers(GPIBbus &bus) {
+  if (inAddressed) {
+    bus.unAddressDevice();
+    bus.setControls(CIDS);
+    inAddressed = false;
+  }
+  outRemaining = 0;
+}
+
+
+#endif  // AR488_USBTMC
@@ -0,0 +1,109 @@
+#ifndef AR488_USBTMC_H
+#define AR488_USBTMC_H
+
+#include "AR488_Config.h"
+
+#ifdef AR488_USBTMC
+
+#ifndef USBCON
+#error AR488_USBTMC requires a board with native USB (e.g. 32u4)
+#endif
+
+#include <PluggableUSB.h>
+#include "AR488_GPIBbus.h"
+
+
+/***** USBTMC interface *****/
+/*
+ * A USBTMC (USB Test & Measurement Class) interface presented alongside the
+ * CDC serial port on boards with native USB. Messages received on the bulk OUT
+ * endpoint are written to the currently addressed instrument, with EOI on the
+ * last byte of a message (EOM). Data requested with REQUEST_DEV_DEP_MSG_IN is
+ * read from the instrument until EOI, the requested TermChar or TransferSize
+ * bytes, up to USBTMC_IN_MAX bytes per transfer, and returned as a sequence of
+ * full packets. Data is passed without any escaping or terminator handling, so
+ * binary transfers are clean.
+ */
+
+#define USBTMC_EP_SIZE 64
+#define USBTMC_HDR_SIZE 12
+#define USBTMC_BUF_SIZE 256   // Transfer buffer (multiple of 4, counted in IO_BUDGET)
+#define USBTMC_IN_MAX (USBTMC_BUF_SIZE - USBTMC_HDR_SIZE)  // Data bytes per IN transfer
+
+// An OUT packet must fit and the padded IN transfer must not run past the end
+static_assert((USBTMC_BUF_SIZE >= USBTMC_EP_SIZE) && ((USBTMC_BUF_SIZE & 0x03) == 0), "USBTMC_BUF_SIZE must be a multiple of 4 no smaller than USBTMC_EP_SIZE");
+
+/***** Interface class *****/
+#define USBTMC_CLASS 0xFE
+#define USBTMC_SUBCLASS 0x03
+#define USBTMC_PROTOCOL 0x00
+
+/***** Bulk message IDs *****/
+#define TMC_DEV_DEP_MSG_OUT 1
+#define TMC_DEV_DEP_MSG_IN 2
+#define TMC_REQUEST_DEV_DEP_MSG_IN 2
+
+/***** Class requests *****/
+#define TMC_INITIATE_ABORT_BULK_OUT 1
+#define TMC_CHECK_ABORT_BULK_OUT_STATUS 2
+#define TMC_INITIATE_ABORT_BULK_IN 3
+#define TMC_CHECK_ABORT_BULK_IN_STATUS 4
+#define TMC_INITIATE_CLEAR 5
+#define TMC_CHECK_CLEAR_STATUS 6
+#define TMC_GET_CAPABILITIES 7
+
+/***** Request status values *****/
+#define TMC_STATUS_SUCCESS 0x01
+#define TMC_STATUS_PENDING 0x02
+#define TMC_STATUS_FAILED 0x80
+#define TMC_STATUS_NOT_IN_PROGRESS 0x81
+
+
+typedef struct {
+  InterfaceDescriptor tmcInterface;
+  EndpointDescriptor out;
+  EndpointDescriptor in;
+} TMCDescriptor;
+
+
+class USBTMC_ : public PluggableUSBModule {
+
+  public:
+
+    USBTMC_();
+    void service(GPIBbus &bus);
+
+  protected:
+
+    int getInterface(uint8_t *interfaceCount);
+    int getDescriptor(USBSetup &setup);
+    bool setup(USBSetup &setup);
+    uint8_t getShortName(char *name);
+
+  private:
+
+    uint8_t epType[2];
+    uint8_t pkt[USBTMC_BUF_SIZE];  // OUT packet, or IN header + data
+    uint32_t outRemaining;      // Bytes of the current OUT message still to come
+    uint32_t outReceived;       // Bytes of the current OUT message received
+    bool outEom;                // Current OUT message ends with EOM
+    uint8_t outTag;
+    bool inAddressed;           // Instrument left addressed to talk between IN transfers
+    uint8_t inTag;
+    volatile bool clearReq;     // INITIATE_CLEAR received
+    volatile bool abortOut;     // INITIATE_ABORT_BULK_OUT received
+    volatile bool abortIn;      // INITIATE_ABORT_BULK_IN received
+
+    uint8_t outEp();
+    uint8_t inEp();
+    void writeOut(GPIBbus &bus, uint8_t *data, uint8_t len);
+    void sendIn(GPIBbus &bus, uint8_t tag, uint32_t maxlen, bool termEn, uint8_t termChar);
+    void endTransfers(GPIBbus &bus);
+};
+
+extern USBTMC_ Usbtmc;
+
+
+#endif  // AR488_USBTMC
+
+#endif  // AR488_USBTMC_H
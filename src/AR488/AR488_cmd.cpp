@@ -5,49 +5,148 @@
 #include "AR488_Eeprom.h"
 #include "AR488_cmd.h"
 
-struct cmdRec cmdHidx [] = { 
-  { "addr",        CMD_DEV | CMD_CONTROLLER, addr_h      }, 
-  { "allspoll",              CMD_CONTROLLER, (void(*)(char*)) aspoll_h  },
-  { "auto",                  CMD_CONTROLLER, amode_h     },
-  { "clr",                   CMD_CONTROLLER, (void(*)(char*)) clr_h     },
-  { "dcl",                   CMD_CONTROLLER, (void(*)(char*)) dcl_h     },
-  { "default",     CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) default_h },
-  { "eoi",         CMD_DEV | CMD_CONTROLLER, eoi_h       },
-  { "eor",         CMD_DEV | CMD_CONTROLLER, eor_h       },
-  { "eos",         CMD_DEV | CMD_CONTROLLER, eos_h       },
-  { "eot_char",    CMD_DEV | CMD_CONTROLLER, eot_char_h  },
-  { "eot_enable",  CMD_DEV | CMD_CONTROLLER, eot_en_h    },
-  { "help",        CMD_DEV | CMD_CONTROLLER, help_h      },
-  { "ifc",                   CMD_CONTROLLER, (void(*)(char*)) ifc_h     },
-  { "id",          CMD_DEV | CMD_CONTROLLER, id_h        },
-  { "idn",         CMD_DEV | CMD_CONTROLLER, idn_h       },
-  { "llo",                   CMD_CONTROLLER, llo_h       },
-  { "loc",                   CMD_CONTROLLER, loc_h       },
-  { "lon",         CMD_DEV                 , lon_h       },
-  { "macro",                 CMD_CONTROLLER, macro_h     },
-  { "mla",                   CMD_CONTROLLER, (void(*)(char*)) sendmla_h },
-  { "mode" ,       CMD_DEV | CMD_CONTROLLER, cmode_h     },
-  { "msa",                   CMD_CONTROLLER, sendmsa_h   },
-  { "mta",                   CMD_CONTROLLER, (void(*)(char*)) sendmta_h },
-  { "ppoll",                 CMD_CONTROLLER, (void(*)(char*)) ppoll_h   },
-  { "prom",        CMD_DEV                 , prom_h      },
-  { "read",                  CMD_CONTROLLER, read_h      },
-  { "read_tmo_ms",           CMD_CONTROLLER, rtmo_h      },
-  { "ren",                   CMD_CONTROLLER, ren_h       },
-  { "repeat",                CMD_CONTROLLER, repeat_h    },
-  { "rst",         CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) rst_h     },
-  { "trg",                   CMD_CONTROLLER, trg_h       },
-  { "savecfg",     CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) save_h    },
-  { "setvstr",     CMD_DEV | CMD_CONTROLLER, setvstr_h   },
-  { "spoll",                 CMD_CONTROLLER, spoll_h     },
-  { "srq",                   CMD_CONTROLLER, (void(*)(char*)) srq_h     },
-  { "srqauto",               CMD_CONTROLLER, srqa_h      },
-  { "status",      CMD_DEV                 , stat_h      },
-  { "ton",         CMD_DEV                 , ton_h       },
-  { "unl",                   CMD_CONTROLLER, (void(*)(char*)) unlisten_h  },
-  { "unt",                   CMD_CONTROLLER, (void(*)(char*)) untalk_h    },
-  { "ver",         CMD_DEV | CMD_CONTROLLER, ver_h       },
-  { "verbose",     CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) verb_h    },
-  { "xdiag",       CMD_DEV | CMD_CONTROLLER, xdiag_h     },
-  { (const char *)0, 0, 0 }
+/***** Command tokens *****/
+static const char ct_addr[] PROGMEM = "addr";
+static const char ct_allspoll[] PROGMEM = "allspoll";
+static const char ct_auto[] PROGMEM = "auto";
+static const char ct_bench[] PROGMEM = "bench";
+static const char ct_bspoll[] PROGMEM = "bspoll";
+static const char ct_clr[] PROGMEM = "clr";
+static const char ct_dcl[] PROGMEM = "dcl";
+static const char ct_default[] PROGMEM = "default";
+static const char ct_eoi[] PROGMEM = "eoi";
+static const char ct_eor[] PROGMEM = "eor";
+static const char ct_eos[] PROGMEM = "eos";
+static const char ct_eot_char[] PROGMEM = "eot_char";
+static const char ct_eot_enable[] PROGMEM = "eot_enable";
+static const char ct_fasths[] PROGMEM = "fasths";
+static const char ct_help[] PROGMEM = "help";
+static const char ct_hs488[] PROGMEM = "hs488";
+static const char ct_id[] PROGMEM = "id";
+static const char ct_idn[] PROGMEM = "idn";
+static const char ct_ifc[] PROGMEM = "ifc";
+static const char ct_llo[] PROGMEM = "llo";
+static const char ct_loc[] PROGMEM = "loc";
+static const char ct_lon[] PROGMEM = "lon";
+static const char ct_macro[] PROGMEM = "macro";
+static const char ct_mla[] PROGMEM = "mla";
+static const char ct_mode[] PROGMEM = "mode";
+static const char ct_msa[] PROGMEM = "msa";
+static const char ct_mta[] PROGMEM = "mta";
+static const char ct_ppconfig[] PROGMEM = "ppconfig";
+static const char ct_ppoll[] PROGMEM = "ppoll";
+static const char ct_prom[] PROGMEM = "prom";
+static const char ct_read[] PROGMEM = "read";
+static const char ct_read_tmo_ms[] PROGMEM = "read_tmo_ms";
+static const char ct_ren[] PROGMEM = "ren";
+static const char ct_repeat[] PROGMEM = "repeat";
+static const char ct_rst[] PROGMEM = "rst";
+static const char ct_savecfg[] PROGMEM = "savecfg";
+static const char ct_setvstr[] PROGMEM = "setvstr";
+static const char ct_simbus[] PROGMEM = "simbus";
+static const char ct_spoll[] PROGMEM = "spoll";
+static const char ct_srq[] PROGMEM = "srq";
+static const char ct_srqauto[] PROGMEM = "srqauto";
+static const char ct_stats[] PROGMEM = "stats";
+static const char ct_status[] PROGMEM = "status";
+static const char ct_sticky[] PROGMEM = "sticky";
+static const char ct_ton[] PROGMEM = "ton";
+static const char ct_trace[] PROGMEM = "trace";
+static const char ct_trg[] PROGMEM = "trg";
+static const char ct_trgread[] PROGMEM = "trgread";
+static const char ct_unl[] PROGMEM = "unl";
+static const char ct_unt[] PROGMEM = "unt";
+static const char ct_ver[] PROGMEM = "ver";
+static const char ct_verbose[] PROGMEM = "verbose";
+static const char ct_wrb[] PROGMEM = "wrb";
+static const char ct_xdiag[] PROGMEM = "xdiag";
+
+/***** Command table *****/
+/*
+ * Held in flash. Entries MUST be kept in alphabetical order of token as
+ * getCmdRec() finds commands using a binary search.
+ */
+const struct cmdRec cmdHidx [] PROGMEM = {
+  { ct_addr,          CMD_DEV | CMD_CONTROLLER, addr_h },
+  { ct_allspoll,                CMD_CONTROLLER, (void(*)(char*)) aspoll_h },
+  { ct_auto,                    CMD_CONTROLLER, amode_h },
+  { ct_bench,         CMD_DEV | CMD_CONTROLLER, bench_h },
+  { ct_bspoll,                  CMD_CONTROLLER, bspoll_h },
+  { ct_clr,                     CMD_CONTROLLER, (void(*)(char*)) clr_h },
+  { ct_dcl,                     CMD_CONTROLLER, (void(*)(char*)) dcl_h },
+  { ct_default,       CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) default_h },
+  { ct_eoi,           CMD_DEV | CMD_CONTROLLER, eoi_h },
+  { ct_eor,           CMD_DEV | CMD_CONTROLLER, eor_h },
+  { ct_eos,           CMD_DEV | CMD_CONTROLLER, eos_h },
+  { ct_eot_char,      CMD_DEV | CMD_CONTROLLER, eot_char_h },
+  { ct_eot_enable,    CMD_DEV | CMD_CONTROLLER, eot_en_h },
+  { ct_fasths,        CMD_DEV | CMD_CONTROLLER, fasths_h },
+  { ct_help,          CMD_DEV | CMD_CONTROLLER, help_h },
+  { ct_hs488,         CMD_DEV | CMD_CONTROLLER, hs488_h },
+  { ct_id,            CMD_DEV | CMD_CONTROLLER, id_h },
+  { ct_idn,           CMD_DEV | CMD_CONTROLLER, idn_h },
+  { ct_ifc,                     CMD_CONTROLLER, (void(*)(char*)) ifc_h },
+  { ct_llo,                     CMD_CONTROLLER, llo_h },
+  { ct_loc,                     CMD_CONTROLLER, loc_h },
+  { ct_lon,           CMD_DEV                 , lon_h },
+  { ct_macro,                   CMD_CONTROLLER, macro_h },
+  { ct_mla,                     CMD_CONTROLLER, (void(*)(char*)) sendmla_h },
+  { ct_mode,          CMD_DEV | CMD_CONTROLLER, cmode_h },
+  { ct_msa,                     CMD_CONTROLLER, sendmsa_h },
+  { ct_mta,                     CMD_CONTROLLER, (void(*)(char*)) sendmta_h },
+  { ct_ppconfig,                CMD_CONTROLLER, ppconfig_h },
+  { ct_ppoll,                   CMD_CONTROLLER, (void(*)(char*)) ppoll_h },
+  { ct_prom,          CMD_DEV                 , prom_h },
+  { ct_read,                    CMD_CONTROLLER, read_h },
+  { ct_read_tmo_ms,             CMD_CONTROLLER, rtmo_h },
+  { ct_ren,                     CMD_CONTROLLER, ren_h },
+  { ct_repeat,                  CMD_CONTROLLER, repeat_h },
+  { ct_rst,           CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) rst_h },
+  { ct_savecfg,       CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) save_h },
+  { ct_setvstr,       CMD_DEV | CMD_CONTROLLER, setvstr_h },
+  { ct_simbus,        CMD_DEV | CMD_CONTROLLER, simbus_h },
+  { ct_spoll,                   CMD_CONTROLLER, spoll_h },
+  { ct_srq,                     CMD_CONTROLLER, (void(*)(char*)) srq_h },
+  { ct_srqauto,                 CMD_CONTROLLER, srqa_h },
+  { ct_stats,         CMD_DEV | CMD_CONTROLLER, stats_h },
+  { ct_status,        CMD_DEV                 , stat_h },
+  { ct_sticky,                  CMD_CONTROLLER, sticky_h },
+  { ct_ton,           CMD_DEV                 , ton_h },
+  { ct_trace,         CMD_DEV | CMD_CONTROLLER, trace_h },
+  { ct_trg,                     CMD_CONTROLLER, trg_h },
+  { ct_trgread,                 CMD_CONTROLLER, trgread_h },
+  { ct_unl,                     CMD_CONTROLLER, (void(*)(char*)) unlisten_h },
+  { ct_unt,                     CMD_CONTROLLER, (void(*)(char*)) untalk_h },
+  { ct_ver,           CMD_DEV | CMD_CONTROLLER, ver_h },
+  { ct_verbose,       CMD_DEV | CMD_CONTROLLER, (void(*)(char*)) verb_h },
+  { ct_wrb,                     CMD_CONTROLLER, wrb_h },
+  { ct_xdiag,         CMD_DEV | CMD_CONTROLLER, xdiag_h },
 };
+
+const uint8_t cmdHidxSize = sizeof(cmdHidx) / sizeof(cmdHidx[0]);
+
+/***** Find a command by token and copy its record from flash *****/
+/*
+ * Returns the index of the command in cmdHidx[] or -1 if not found
+ */
+int getCmdRec(const char *token, struct cmdRec *rec) {
+  int low = 0;
+  int high = cmdHidxSize - 1;
+  int mid;
+  int cmp;
+
+  while (low <= high) {
+    mid = (low + high) / 2;
+    cmp = strcasecmp_P(token, (const char *)pgm_read_ptr(&cmdHidx[mid].token));
+    if (cmp == 0) {
+      memcpy_P(rec, &cmdHidx[mid], sizeof(struct cmdRec));
+      return mid;
+    }
+    if (cmp < 0) {
+      high = mid - 1;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return -1;
+}
@@ -7,7 +7,10 @@ struct cmdRec {
   void (*handler)(char *);
 };
 
-extern struct cmdRec cmdHidx [];
+extern const struct cmdRec cmdHidx [];
+extern const uint8_t cmdHidxSize;
+
+int getCmdRec(const char *token, struct cmdRec *rec);
 
 #define CMD_DEV 1
 #define CMD_CONTROLLER 2
@@ -25,6 +28,9 @@ void eoi_h(char *params);
 void cmode_h(char *params);
 void eot_en_h(char *params);
 void eot_char_h(char *params);
+void fasths_h(char *params);
+void hs488_h(char *params);
+void sticky_h(char *params);
 void amode_h(char *params);
 void ver_h(char *params);
 void read_h(char *params);
@@ -33,26 +39,34 @@ void llo_h(char *params);
 void loc_h(char *params);
 void ifc_h();
 void trg_h(char *params);
+void trgread_h(char *params);
 void rst_h();
 void spoll_h(char *params);
 void srq_h();
 void stat_h(char *params);
+void stats_h(char *params);
 void save_h();
 void lon_h(char *params);
 void help_h(char *params);
 void aspoll_h();
+void bench_h(char *params);
+void bspoll_h(char *params);
 void dcl_h();
 void default_h();
 void eor_h(char *params);
 void ppoll_h();
+void ppconfig_h(char *params);
 void ren_h(char *params);
 void verb_h();
 void setvstr_h(char *params);
 void prom_h(char *params);
 void ton_h(char *params);
+void trace_h(char *params);
+void simbus_h(char *params);
 void srqa_h(char *params);
 void repeat_h(char *params);
 void macro_h(char *params);
+void wrb_h(char *params);
 void xdiag_h(char *params);
 void id_h(char *params);
 void idn_h(char * params);
@@ -62,15 +76,10 @@ void sendmsa_h(char *params);
 void unlisten_h();
 void untalk_h();
 
-void attnRequired();
-void execGpibCmd(uint8_t gpibcmd);
+void attnRequired(uint8_t dstate, uint8_t saddr);
 void device_listen_h();
 void device_talk_h();
 void device_sdc_h();
-void device_spd_h();
-void device_spe_h();
-bool device_unl_h();
-bool device_unt_h();
 void lonMode();
 void tonMode();
 
@@ -11,9 +11,9 @@ static const char cmdHelp[] PROGMEM = {
   "ifc:P Assert IFC signal for 150 miscoseconds - make AR488 controller in charge\n"
   "llo:P Local lockout - disable front panel operation on instrument\n"
   "loc:P Enable front panel operation on instrument\n"
-  "lon:P Put controller in listen-only mode (listen to all traffic)\n"
+  "lon:P Put controller in listen-only mode (listen to all traffic, 2=binary capture frames)\n"
   "mode:P Set the interface mode (0=controller/1=device)\n"
-  "read:P Read data from instrument\n"
+  "read:P Read data from instrument - 'read [eoi|blk|<char> ...] [count <n>]' (blk: IEEE 488.2 #<n><len> binary block)\n"
   "read_tmo_ms:P Read timeout specified between 1 - 3000 milliseconds\n"
   "rst:P Reset the controller\n"
   "savecfg:P Save configration\n"
@@ -23,20 +23,31 @@ static const char cmdHelp[] PROGMEM = {
   "trg:P Send trigger to selected devices (up to 15 addresses)\n"
   "ver:P Display firmware version\n"
   "aspoll:C Serial poll all instruments (alias: ++spoll all)\n"
+  "bench:C Measure throughput - 'bench write|read|serial [count]'\n"
+  "bspoll:C Batch serial poll of listed or known present devices, all status bytes on one line\n"
   "dcl:C Send unaddressed (all) device clear  [power on reset] (is the rst?)\n"
   "default:C Set configuration to controller default settings\n"
+  "fasths:C Enable/disable the fast (tight loop) GPIB handshake\n"
+  "hs488:C Enable/disable the HS488 non-interlocked handshake when sending to an HS488 capable instrument\n"
   "id:C Show interface ID information - see also: 'id name'; 'id serial'; 'id verstr'\n"
   "id name:C Show/Set the name of the interface\n"
   "id serial:C Show/Set the serial number of the interface\n"
   "id verstr:C Show/Set the version string sent in reply to ++ver e.g. \"GPIB-USB\"). Max 47 chars, excess truncated.\n"
   "idn:C Enable/Disable reply to *idn? (disabled by default)\n"
-  "macro:C Run a macro (if macro support is compiled)\n"
+  "macro:C Run a macro (if macro support is compiled) - see also: 'macro add'; 'macro clear'\n"
+  "ppconfig:C Assign a parallel poll line to a device - 'ppconfig addr line [sense]'; 'ppconfig addr off'; 'ppconfig clear'\n"
   "ppoll:C Conduct a parallel poll\n"
   "ren:C Assert or Unassert the REN signal\n"
-  "repeat:C Repeat a given command and return result\n"
+  "repeat:C Send a command every period and return timestamped results - see also: 'repeat addr'; 'repeat stop'\n"
   "setvstr:C DEPRECATED - see id verstr\n"
-  "srqauto:C Automatically condiuct serial poll when SRQ is asserted\n"
+  "simbus:C Show simulated bus call counters (if simulated bus is compiled) - see also: 'simbus reset|delay <n>|len <n>'\n"
+  "srqauto:C Automatically condiuct serial poll when SRQ is asserted (2=interrupt notify, 3=parallel poll)\n"
+  "stats:C Show transfer statistics, or clear them with 'stats reset'\n"
+  "sticky:C Leave the instrument addressed between transfers (skip redundant addressing)\n"
   "ton:C Put controller in talk-only mode (send data only)\n"
+  "trace:C Print and clear the bus trace buffer (if trace support is compiled) - see also: 'trace on|off|clear'\n"
+  "trgread:C Trigger a group of devices with one GET and read each result as addr:value\n"
   "verbose:C Verbose (human readable) mode\n"
+  "wrb:C Write the next <len> bytes from the host to the instrument unchanged, with EOI on the last - 'wrb <len>'\n"
   "xdiag:C Bus diagnostics (see the doc)\n"
 };
@@ -0,0 +1,164 @@
+#include <Arduino.h>
+
+#include "AR488_Config.h"
+#include "AR488_GPIBbus.h"
+#include "AR488_SimBus.h"
+
+/***** Handshake benchmark against the simulated bus *****/
+/*
+ * Runs the same write and read loops as ++bench with the staged, ++fasths and
+ * ++hs488 handshakes, at several instrument response delays, and prints the
+ * line function calls per byte. These depend only on the firmware, so a change
+ * can be compared with the previous build before flashing. The host time per
+ * byte is shown for reference only. A receiveData() pass and a serial poll
+ * check that complete transactions still work.
+ *
+ * Usage: ar488_bench [count]  (default 1000 bytes per run)
+ * Exits with 1 if any transfer did not complete.
+ */
+
+#define LF   0xA    // Newline/linefeed
+
+GPIBbus gpibBus;
+
+/***** Stream that counts what GPIBbus delivers to the host *****/
+class CountStream : public Stream {
+  public:
+    uint32_t count = 0;
+    uint8_t last = 0;
+    size_t write(uint8_t c) { count++; last = c; return 1; }
+    using Print::write;
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+};
+
+static const char *modeName[3] = { "staged", "fasths", "hs488" };
+static const uint8_t delays[3] = { 0, 2, 8 };
+static bool failed = false;
+
+static void setMode(uint8_t mode) {
+  gpibBus.fastHs = (mode == 1);
+  gpibBus.hs488 = (mode == 2);
+}
+
+static void report(const char *mode, uint8_t dly, const char *dir, uint16_t done, uint16_t cnt, unsigned long us) {
+  printf("%-6s delay %u %-5s %5u bytes  hs=%6.2f ctrl=%5.2f dbus=%5.2f  %7.1f ns/byte%s\n",
+    mode, dly, dir, done,
+    done ? (double)simStat.hsReads / done : 0.0,
+    done ? (double)simStat.ctrlSets / done : 0.0,
+    done ? (double)(simStat.dbusReads + simStat.dbusWrites) / done : 0.0,
+    done ? (double)us * 1000.0 / done : 0.0,
+    (done == cnt) ? "" : "  INCOMPLETE");
+  if (done != cnt) failed = true;
+}
+
+static void benchWrite(uint8_t mode, uint8_t dly, uint16_t cnt) {
+  uint16_t done;
+  unsigned long tstart;
+
+  setMode(mode);
+  simDelay = dly;
+  if (gpibBus.addressDevice(gpibBus.cfg.paddr, LISTEN)) {
+    printf("%s: failed to address device to listen\n", modeName[mode]);
+    failed = true;
+    return;
+  }
+  gpibBus.setControls(CTAS);
+  simClearStats();
+  tstart = micros();
+  for (done = 0; done < cnt; done++) {
+    if (gpibBus.writeByte((done == cnt - 1) ? LF : ' ', (done == cnt - 1))) break;
+  }
+  report(modeName[mode], dly, "write", done, cnt, micros() - tstart);
+  gpibBus.unAddressDevice();
+  gpibBus.setControls(CIDS);
+}
+
+static void benchRead(uint8_t mode, uint8_t dly, uint16_t cnt) {
+  uint16_t done;
+  uint8_t db = 0;
+  bool eoi = false;
+  unsigned long tstart;
+
+  setMode(mode);
+  simDelay = dly;
+  simLen = cnt;
+  if (gpibBus.addressDevice(gpibBus.cfg.paddr, TALK)) {
+    printf("%s: failed to address device to talk\n", modeName[mode]);
+    failed = true;
+    return;
+  }
+  gpibBus.setControls(CLAS);
+  simClearStats();
+  tstart = micros();
+  for (done = 0; done < cnt; ) {
+    if (gpibBus.readByte(&db, true, &eoi)) break;
+    done++;
+    if (eoi) break;
+  }
+  report(modeName[mode], dly, "read", done, cnt, micros() - tstart);
+  if (!eoi || (db != LF)) {
+    printf("%s: response did not end with LF and EOI\n", modeName[mode]);
+    failed = true;
+  }
+  gpibBus.unAddressDevice();
+  gpibBus.setControls(CIDS);
+}
+
+/***** A complete read through receiveData() *****/
+static void checkReceive(uint16_t cnt) {
+  CountStream out;
+
+  setMode(0);
+  simDelay = 0;
+  simLen = cnt;
+  gpibBus.receiveData(out, true);
+  printf("receiveData %u of %u bytes\n", (unsigned)out.count, cnt);
+  if ((out.count != cnt) || (out.last != LF)) failed = true;
+}
+
+/***** Serial poll a virtual instrument and an empty address *****/
+static void checkSerialPoll() {
+  uint8_t sb = 0xFF;
+  uint8_t r1;
+  uint8_t r2;
+  int rtmo = gpibBus.cfg.rtmo;
+
+  gpibBus.cfg.rtmo = 20;
+  if (gpibBus.startSerialPoll()) {
+    printf("spoll: failed to start\n");
+    failed = true;
+    return;
+  }
+  r1 = gpibBus.serialPoll(SIM_ADDR, &sb);
+  r2 = gpibBus.serialPoll(SIM_ADDR + SIM_DEVICES, &sb);
+  gpibBus.endSerialPoll();
+  gpibBus.cfg.rtmo = rtmo;
+  printf("spoll %u: %u (status %u), spoll %u: %u\n", SIM_ADDR, r1, sb, SIM_ADDR + SIM_DEVICES, r2);
+  if ((r1 != 0) || (r2 == 0)) failed = true;
+}
+
+int main(int argc, char *argv[]) {
+  uint16_t cnt = 1000;
+
+  if (argc > 1) cnt = (uint16_t)strtoul(argv[1], NULL, 10);
+  if ((cnt < 2) || (cnt > 65000)) {
+    printf("count must be between 2 and 65000\n");
+    return 2;
+  }
+
+  gpibBus.begin();
+  gpibBus.cfg.paddr = SIM_ADDR;
+
+  for (uint8_t mode = 0; mode < 3; mode++) {
+    for (uint8_t i = 0; i < sizeof(delays); i++) {
+      benchWrite(mode, delays[i], cnt);
+      benchRead(mode, delays[i], cnt);
+    }
+  }
+  checkReceive(cnt);
+  checkSerialPoll();
+
+  return failed ? 1 : 0;
+}
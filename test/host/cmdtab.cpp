@@ -0,0 +1,51 @@
+#include <ctype.h>
+#include <Arduino.h>
+
+#include "AR488_Config.h"
+#include "AR488_cmd.h"
+
+/***** Command table checks *****/
+/*
+ * getCmdRec() finds commands with a binary search, so cmdHidx[] must stay in
+ * strcasecmp() order. Every token must be found at its own index, in any case,
+ * and unknown or partial tokens must not be found.
+ */
+
+int main() {
+  struct cmdRec rec;
+  char upper[32];
+  int fails = 0;
+
+  for (uint8_t i = 0; i < cmdHidxSize; i++) {
+    const char *token = cmdHidx[i].token;
+
+    if ((i > 0) && (strcasecmp(cmdHidx[i - 1].token, token) >= 0)) {
+      printf("out of order: %s before %s\n", cmdHidx[i - 1].token, token);
+      fails++;
+    }
+    if ((getCmdRec(token, &rec) != i) || (rec.handler != cmdHidx[i].handler)) {
+      printf("not found: %s\n", token);
+      fails++;
+    }
+    if (!cmdHidx[i].handler || !(cmdHidx[i].opmode & (CMD_DEV | CMD_CONTROLLER))) {
+      printf("no handler or mode: %s\n", token);
+      fails++;
+    }
+    for (uint8_t j = 0; j < sizeof(upper); j++) {
+      upper[j] = toupper(token[j]);
+      if (!token[j]) break;
+    }
+    upper[sizeof(upper) - 1] = '\0';
+    if (getCmdRec(upper, &rec) != i) {
+      printf("not found: %s\n", upper);
+      fails++;
+    }
+  }
+
+  if (getCmdRec("nosuchcmd", &rec) != -1) fails++;
+  if (getCmdRec("", &rec) != -1) fails++;
+  if (getCmdRec("ad", &rec) != -1) fails++;
+
+  printf("%u commands, %d failures\n", cmdHidxSize, fails);
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#include <chrono>
+#include <thread>
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+/***** Host implementations of the Arduino core functions *****/
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+EEPROMClass EEPROM;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Handshake timing is counted in line reads by the simulated bus, so short
+// delays are not slept
+void delayMicroseconds(unsigned int) {}
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void digitalWrite(uint8_t, uint8_t) {}
+
+int digitalPinToInterrupt(uint8_t) { return NOT_AN_INTERRUPT; }
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
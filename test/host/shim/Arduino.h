@@ -0,0 +1,146 @@
+#ifndef AR488_HOST_ARDUINO_H
+#define AR488_HOST_ARDUINO_H
+
+/***** Minimal Arduino core for building the sketch modules on the host *****/
+/*
+ * Only what the modules built by test/host/CMakeLists.txt use. Pins are not
+ * modelled: the builds use AR488_SIMBUS, which replaces the pin functions.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "avr/pgmspace.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define A0 18
+#define A1 19
+#define A2 20
+#define A3 21
+#define A4 22
+#define A5 23
+
+#define NOT_AN_INTERRUPT -1
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+#define noInterrupts()
+#define interrupts()
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t irq, void (*isr)(), int mode);
+void detachInterrupt(uint8_t irq);
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t len) {
+      size_t n = 0;
+      while (len--) n += write(*buf++);
+      return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buf, size_t len) { return write((const uint8_t *)buf, len); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC) {
+      if ((base == DEC) && (n < 0)) return print('-') + print((unsigned long)-n, base);
+      return print((unsigned long)n, base);
+    }
+    size_t print(unsigned long n, int base = DEC) {
+      char buf[8 * sizeof(long) + 1];
+      char *p = &buf[sizeof(buf) - 1];
+      *p = '\0';
+      if (base < 2) base = 10;
+      do {
+        uint8_t d = n % base;
+        *--p = (d < 10) ? ('0' + d) : ('A' + d - 10);
+        n /= base;
+      } while (n);
+      return write(p);
+    }
+    size_t print(double n, int digits = 2) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.*f", digits, n);
+      return write(buf);
+    }
+
+    size_t println() { return write("\r\n"); }
+    template<typename T> size_t println(T v) { return print(v) + println(); }
+    template<typename T> size_t println(T v, int f) { return print(v, f) + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long) {}
+    size_t readBytes(char *buf, size_t len) {
+      size_t n = 0;
+      int c;
+      while ((n < len) && ((c = read()) >= 0)) buf[n++] = (char)c;
+      return n;
+    }
+};
+
+/***** Serial port: output to stdout, no input *****/
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    void end() {}
+    size_t write(uint8_t c) { return (putchar(c) == EOF) ? 0 : 1; }
+    using Print::write;
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    int availableForWrite() { return 64; }
+    void flush() { fflush(stdout); }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+#endif  // AR488_HOST_ARDUINO_H
@@ -0,0 +1,16 @@
+#ifndef AR488_HOST_DEVNULL_H
+#define AR488_HOST_DEVNULL_H
+
+#include <Arduino.h>
+
+/***** Stream that discards output and has no input *****/
+class DEVNULL : public Stream {
+  public:
+    size_t write(uint8_t) { return 1; }
+    using Print::write;
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+};
+
+#endif  // AR488_HOST_DEVNULL_H
@@ -0,0 +1,28 @@
+#ifndef AR488_HOST_EEPROM_H
+#define AR488_HOST_EEPROM_H
+
+#include <Arduino.h>
+
+/***** EEPROM held in RAM (erased = 0xFF) *****/
+#define E2END 1023
+
+struct EEPROMClass {
+  uint8_t mem[E2END + 1];
+  EEPROMClass() { memset(mem, 0xFF, sizeof(mem)); }
+  uint8_t read(int addr) { return mem[addr & E2END]; }
+  void write(int addr, uint8_t val) { mem[addr & E2END] = val; }
+  void update(int addr, uint8_t val) { mem[addr & E2END] = val; }
+  uint16_t length() { return E2END + 1; }
+  template<typename T> T& get(int addr, T& t) {
+    memcpy(&t, &mem[addr & E2END], sizeof(T));
+    return t;
+  }
+  template<typename T> const T& put(int addr, const T& t) {
+    memcpy(&mem[addr & E2END], &t, sizeof(T));
+    return t;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif  // AR488_HOST_EEPROM_H
@@ -0,0 +1,32 @@
+#ifndef AR488_HOST_PGMSPACE_H
+#define AR488_HOST_PGMSPACE_H
+
+/***** Flash access on the host: flash is ordinary memory *****/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_byte_near(p) pgm_read_byte(p)
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+#endif  // AR488_HOST_PGMSPACE_H